@@ -0,0 +1,88 @@
+#include <ext/adaptive_mutex>
+#include <gtest/gtest.h>
+
+#if defined(_EXT_ADAPTIVE_MUTEX_)
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+TEST(adaptive_mutex, lock_test) {
+  ext::adaptive_mutex mtx;
+  mtx.lock();
+  EXPECT_FALSE(mtx.try_lock());
+  mtx.unlock();
+  EXPECT_TRUE(mtx.try_lock());
+  mtx.unlock();
+}
+
+TEST(adaptive_mutex, shared_reentrant_test) {
+  ext::adaptive_mutex mtx;
+  mtx.lock_shared();
+  mtx.lock_shared();
+  EXPECT_TRUE(mtx.try_lock_shared());
+  EXPECT_FALSE(mtx.try_lock());
+
+  bool acquired = true;
+  std::thread other([&mtx, &acquired]() { acquired = mtx.try_lock_shared(); });
+  other.join();
+  EXPECT_FALSE(acquired);
+
+  mtx.unlock_shared();
+  mtx.unlock_shared();
+  EXPECT_FALSE(mtx.try_lock());
+  mtx.unlock_shared();
+  EXPECT_TRUE(mtx.try_lock());
+  mtx.unlock();
+}
+
+TEST(adaptive_mutex, contention_test) {
+  ext::adaptive_mutex mtx;
+  long long value = 0;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([&mtx, &value]() {
+      for (int n = 0; n < 20000; ++n) {
+        std::lock_guard<ext::adaptive_mutex> lock(mtx);
+        ++value;
+      }
+    }));
+  }
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i].join();
+  EXPECT_EQ(value, 8 * 20000);
+}
+
+TEST(adaptive_mutex, park_test) {
+  // Holding the lock for a long time makes waiters park instead of spinning.
+  ext::adaptive_mutex mtx;
+  bool done = false;
+  mtx.lock();
+  std::thread waiter([&mtx, &done]() {
+    std::lock_guard<ext::adaptive_mutex> lock(mtx);
+    done = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(done);
+  mtx.unlock();
+  waiter.join();
+  EXPECT_TRUE(done);
+}
+
+TEST(adaptive_mutex, condition_variable_test) {
+  ext::adaptive_mutex mtx;
+  std::condition_variable_any cv;
+  bool ready = false;
+  std::thread producer([&]() {
+    std::lock_guard<ext::adaptive_mutex> lock(mtx);
+    ready = true;
+    cv.notify_one();
+  });
+  {
+    std::unique_lock<ext::adaptive_mutex> lock(mtx);
+    cv.wait(lock, [&ready]() { return ready; });
+  }
+  producer.join();
+  EXPECT_TRUE(ready);
+}
+#endif // _EXT_ADAPTIVE_MUTEX_
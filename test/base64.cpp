@@ -1,6 +1,15 @@
 ﻿#include <ext/base64>
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include <ext/pipe>
+#include <ext/thread_pool>
+
 TEST(base64_test, mbcs_test) {
 #if defined(CXX_AUTO_TYPE_NOT_SUPPORTED) ||                                    \
     defined(CXX_DEFAULT_TEMPLATE_ARGUMENTS_NOT_SUPPORTED)
@@ -620,4 +629,395 @@ TEST(base64_test, struct_test) {
   EXPECT_EQ(result->c, 'a');
   EXPECT_EQ(result->d, 30.30);
 }
-#endif // CXX_AUTO_TYPE_NOT_SUPPORTED
\ No newline at end of file
+#endif // CXX_AUTO_TYPE_NOT_SUPPORTED
+namespace {
+std::vector<std::byte> random_bytes(size_t size, unsigned int seed) {
+  std::vector<std::byte> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    seed = seed * 1103515245u + 12345u;
+    data[i] = static_cast<std::byte>(seed >> 16);
+  }
+  return data;
+}
+
+std::vector<ext::base64::simd_level> supported_simd_levels() {
+  std::vector<ext::base64::simd_level> levels;
+  for (int level = ext::base64::simd_none;
+       level <= ext::base64::supported_simd(); ++level)
+    levels.push_back(static_cast<ext::base64::simd_level>(level));
+  return levels;
+}
+} // namespace
+
+TEST(base64_test, simd_matches_scalar) {
+  ext::base64::simd_level saved = ext::base64::simd();
+  std::vector<ext::base64::simd_level> levels = supported_simd_levels();
+  for (size_t size = 0; size < 300; size += (size < 100 ? 1 : 7)) {
+    std::vector<std::byte> data = random_bytes(size + 1, (unsigned int)size);
+    data.resize(size);
+
+    ASSERT_TRUE(ext::base64::set_simd(ext::base64::simd_none));
+    std::string expected = size ? ext::base64::encode(data) : std::string();
+    // Characters that are not digits, such as line breaks, take the scalar
+    // path, which must give the same result as before.
+    std::string wrapped;
+    for (size_t i = 0; i < expected.size(); i += 76)
+      wrapped += expected.substr(i, 76) + "\r\n";
+    std::vector<std::byte> expected_wrapped =
+        size ? ext::base64::decode(wrapped) : std::vector<std::byte>();
+
+    for (size_t l = 0; l < levels.size(); ++l) {
+      ASSERT_TRUE(ext::base64::set_simd(levels[l]));
+      if (size == 0)
+        continue;
+      EXPECT_EQ(ext::base64::encode(data), expected)
+          << "level " << levels[l] << ", size " << size;
+      EXPECT_EQ(ext::base64::decode(expected), data)
+          << "level " << levels[l] << ", size " << size;
+      EXPECT_EQ(ext::base64::decode(wrapped), expected_wrapped)
+          << "level " << levels[l] << ", size " << size;
+    }
+  }
+  // A character that is not a digit inside a vector block falls back to the
+  // scalar loop.
+  std::string text(257, 'Q');
+  text[70] = '!';
+  ASSERT_TRUE(ext::base64::set_simd(ext::base64::simd_none));
+  std::vector<std::byte> expected = ext::base64::decode(text);
+  for (size_t l = 0; l < levels.size(); ++l) {
+    ASSERT_TRUE(ext::base64::set_simd(levels[l]));
+    EXPECT_EQ(ext::base64::decode(text), expected) << "level " << levels[l];
+  }
+  EXPECT_FALSE(ext::base64::set_simd(
+      static_cast<ext::base64::simd_level>(ext::base64::supported_simd() + 1)));
+  ext::base64::set_simd(saved);
+}
+
+TEST(base64_test, encode_into_decode_into) {
+  EXPECT_EQ(ext::base64::encoded_size(0), 0u);
+  EXPECT_EQ(ext::base64::encoded_size(1), 4u);
+  EXPECT_EQ(ext::base64::encoded_size(3), 4u);
+  EXPECT_EQ(ext::base64::encoded_size(4), 8u);
+  EXPECT_EQ(ext::base64::max_decoded_size(8), 6u);
+  EXPECT_EQ(ext::base64::decoded_size("MTIzNA==", 8), 4u);
+  EXPECT_EQ(ext::base64::decoded_size(L"MTIzNDU=", 8), 5u);
+  EXPECT_EQ(ext::base64::decoded_size("MTIzNDU2", 8), 6u);
+  EXPECT_EQ(ext::base64::decoded_size("MTIz", 4), 3u);
+  EXPECT_EQ(ext::base64::decoded_size("", 0), 0u);
+
+  ext::base64::simd_level saved = ext::base64::simd();
+  std::vector<ext::base64::simd_level> levels = supported_simd_levels();
+  for (size_t l = 0; l < levels.size(); ++l) {
+    ASSERT_TRUE(ext::base64::set_simd(levels[l]));
+    for (size_t size = 0; size < 300; size += (size < 100 ? 1 : 7)) {
+      std::vector<std::byte> data = random_bytes(size + 1, (unsigned int)size);
+      data.resize(size);
+
+      char encoded[512];
+      size_t length = ext::base64::encode_into(data.data(), size, encoded,
+                                               sizeof(encoded));
+      ASSERT_EQ(length, ext::base64::encoded_size(size));
+      if (size)
+        EXPECT_EQ(std::string(encoded, length), ext::base64::encode(data));
+
+      std::vector<std::byte> decoded(ext::base64::max_decoded_size(length));
+      EXPECT_EQ(ext::base64::decoded_size(encoded, length), size);
+      ASSERT_EQ(ext::base64::decode_into(encoded, length, decoded.data(),
+                                         decoded.size()),
+                size)
+          << "level " << levels[l] << ", size " << size;
+      decoded.resize(size);
+      EXPECT_EQ(decoded, data) << "level " << levels[l] << ", size " << size;
+
+      // Line breaks are skipped.
+      std::string wrapped;
+      for (size_t i = 0; i < length; i += 76)
+        wrapped += std::string(encoded + i, std::min<size_t>(76, length - i)) +
+                   "\r\n";
+      decoded.assign(ext::base64::max_decoded_size(wrapped.size()),
+                     std::byte());
+      ASSERT_EQ(ext::base64::decode_into(wrapped, decoded.data(),
+                                         decoded.size()),
+                size);
+      decoded.resize(size);
+      EXPECT_EQ(decoded, data) << "level " << levels[l] << ", size " << size;
+    }
+  }
+  ext::base64::set_simd(saved);
+
+  unsigned char out[16];
+  EXPECT_EQ(ext::base64::decode_into(L"MTIzNA==", 8, out, sizeof(out)), 4u);
+  EXPECT_EQ(memcmp(out, "1234", 4), 0);
+  EXPECT_EQ(ext::base64::decode_into("MTIzNA", 0, out, sizeof(out)), 0u);
+  EXPECT_THROW(ext::base64::decode_into("MTIzNA==", 8, out, 3),
+               std::length_error);
+  EXPECT_THROW(ext::base64::decode_into("MTIzNA", 6, out, sizeof(out)),
+               std::runtime_error);
+  EXPECT_THROW(ext::base64::decode_into("MTI!NA==", 8, out, sizeof(out)),
+               std::runtime_error);
+  EXPECT_THROW(ext::base64::decode_into("M===", 4, out, sizeof(out)),
+               std::runtime_error);
+  EXPECT_THROW(ext::base64::decode_into("MQ==MTIz", 8, out, sizeof(out)),
+               std::runtime_error);
+  EXPECT_THROW(ext::base64::decode_into("MQ=a", 4, out, sizeof(out)),
+               std::runtime_error);
+
+  char small[4];
+  EXPECT_THROW(ext::base64::encode_into("1234", 4, small, sizeof(small)),
+               std::length_error);
+}
+
+TEST(base64_test, incremental) {
+  std::vector<std::byte> data = random_bytes(10000, 7);
+  std::string expected = ext::base64::encode(data);
+  // Chunk sizes that split groups and quanta at every offset.
+  for (size_t chunk = 1; chunk < 20; ++chunk) {
+    ext::base64::encoder encoder;
+    std::string encoded;
+    for (size_t i = 0; i < data.size(); i += chunk)
+      encoder.update(&data[i], std::min(chunk, data.size() - i), encoded);
+    encoder.finish(encoded);
+    ASSERT_EQ(encoded, expected) << "chunk " << chunk;
+
+    ext::base64::decoder decoder;
+    std::vector<std::byte> decoded;
+    for (size_t i = 0; i < encoded.size(); i += chunk)
+      decoder.update(&encoded[i], std::min(chunk, encoded.size() - i),
+                     decoded);
+    decoder.finish();
+    ASSERT_EQ(decoded, data) << "chunk " << chunk;
+  }
+
+  // Line breaks between chunks, and wide text.
+  ext::base64::decoder decoder;
+  std::vector<std::byte> decoded;
+  decoder.update(L"MTI", 3, decoded);
+  decoder.update(L"\r\nz", 3, decoded);
+  decoder.update(L"NA=", 3, decoded);
+  decoder.update(L"=\n", 2, decoded);
+  decoder.finish();
+  ASSERT_EQ(decoded.size(), 4u);
+  EXPECT_EQ(memcmp(decoded.data(), "1234", 4), 0);
+
+  decoder.update("MTIzN", 5, decoded);
+  EXPECT_THROW(decoder.finish(), std::runtime_error);
+  decoder.update("MQ==", 4, decoded);
+  EXPECT_THROW(decoder.update("MQ", 2, decoded), std::runtime_error);
+}
+
+TEST(base64_test, streambuf) {
+  std::vector<std::byte> data = random_bytes(100000, 9);
+  std::string expected = ext::base64::encode(data);
+
+  std::ostringstream encoded;
+  {
+    ext::base64::encoding_streambuf buffer(encoded.rdbuf());
+    std::ostream stream(&buffer);
+    for (size_t i = 0; i < data.size(); i += 1000)
+      stream.write(reinterpret_cast<const char *>(&data[i]), 1000);
+    stream.flush();
+    // Only complete groups are written before finish().
+    EXPECT_EQ(encoded.str(), expected.substr(0, 133332));
+    EXPECT_TRUE(buffer.finish());
+    EXPECT_FALSE(stream.put('x'));
+  }
+  EXPECT_EQ(encoded.str(), expected);
+
+  std::ostringstream decoded;
+  {
+    ext::base64::decoding_streambuf buffer(decoded.rdbuf());
+    std::ostream stream(&buffer);
+    stream << expected;
+  }
+  EXPECT_EQ(decoded.str(),
+            std::string(reinterpret_cast<const char *>(data.data()),
+                        data.size()));
+
+  std::ostringstream rejected;
+  ext::base64::decoding_streambuf buffer(rejected.rdbuf());
+  std::ostream stream(&buffer);
+  stream << "MTI!" << std::flush;
+  EXPECT_TRUE(stream.bad());
+}
+
+TEST(base64_test, stream_through_pipe) {
+  std::vector<std::byte> data = random_bytes(1 << 20, 11);
+  std::string text(reinterpret_cast<const char *>(data.data()), data.size());
+
+  ext::pipe pipe;
+  std::thread writer([&pipe, &text]() {
+    std::istringstream input(text);
+    ext::base64::encode_stream(input, pipe.out());
+    pipe.out().close();
+  });
+  std::ostringstream encoded;
+  encoded << pipe.in().rdbuf();
+  writer.join();
+  EXPECT_EQ(encoded.str(), ext::base64::encode(data));
+
+  std::istringstream input(encoded.str());
+  std::ostringstream decoded;
+  EXPECT_TRUE(ext::base64::decode_stream(input, decoded));
+  EXPECT_EQ(decoded.str(), text);
+}
+
+// Prints timings only; run it with --gtest_also_run_disabled_tests.
+TEST(base64_test, DISABLED_throughput_benchmark) {
+  static const char *names[] = {"scalar", "ssse3", "avx2", "avx512vbmi"};
+  ext::base64::simd_level saved = ext::base64::simd();
+  std::vector<ext::base64::simd_level> levels = supported_simd_levels();
+  const size_t sizes[] = {1 << 10, 64 << 10, 1 << 20, 64 << 20};
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+    std::vector<std::byte> data = random_bytes(sizes[s], 1);
+    // About 64 MB per measurement.
+    size_t rounds = (64 << 20) / sizes[s];
+    for (size_t l = 0; l < levels.size(); ++l) {
+      ext::base64::set_simd(levels[l]);
+      std::string encoded;
+      std::chrono::steady_clock::time_point start =
+          std::chrono::steady_clock::now();
+      for (size_t r = 0; r < rounds; ++r)
+        encoded = ext::base64::encode(data);
+      double encode_seconds =
+          std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+              .count();
+
+      std::vector<std::byte> decoded;
+      start = std::chrono::steady_clock::now();
+      for (size_t r = 0; r < rounds; ++r)
+        decoded = ext::base64::decode(encoded);
+      double decode_seconds =
+          std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+              .count();
+      EXPECT_EQ(decoded, data);
+
+      // decode_into a preallocated buffer.
+      start = std::chrono::steady_clock::now();
+      for (size_t r = 0; r < rounds; ++r)
+        ext::base64::decode_into(encoded.data(), encoded.size(),
+                                 decoded.data(), decoded.size());
+      double decode_into_seconds =
+          std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+              .count();
+
+      double megabytes = static_cast<double>(sizes[s] * rounds) / (1 << 20);
+      std::cout << "base64 " << names[levels[l]] << " " << (sizes[s] >> 10)
+                << " KB: encode " << megabytes / encode_seconds
+                << " MB/s, decode " << megabytes / decode_seconds
+                << " MB/s, decode_into " << megabytes / decode_into_seconds
+                << " MB/s\n";
+    }
+  }
+  ext::base64::set_simd(saved);
+}
+
+TEST(base64_test, parallel_matches_serial) {
+  ext::thread_pool pool(4);
+  const size_t sizes[] = {0, 100, _EXT_BASE64_PARALLEL_MIN_SIZE_,
+                          _EXT_BASE64_PARALLEL_MIN_SIZE_ + 1,
+                          _EXT_BASE64_PARALLEL_MIN_SIZE_ + 2,
+                          _EXT_BASE64_PARALLEL_MIN_SIZE_ * 3 + 7};
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+    std::vector<std::byte> data = random_bytes(sizes[s], (unsigned int)s);
+    std::string encoded = ext::base64::encode(data);
+    for (size_t chunk_count = 0; chunk_count <= 7; chunk_count += 7) {
+      EXPECT_EQ(ext::base64::encode_parallel(pool, data, chunk_count), encoded);
+      EXPECT_EQ(ext::base64::decode_parallel(pool, encoded, chunk_count), data);
+    }
+    std::vector<std::byte> decoded(data.size());
+    EXPECT_EQ(ext::base64::decode_parallel_into(pool, encoded.data(),
+                                                encoded.size(), decoded.data(),
+                                                decoded.size(), 5),
+              data.size());
+    EXPECT_EQ(decoded, data);
+  }
+}
+
+TEST(base64_test, parallel_decode_falls_back) {
+  ext::thread_pool pool(4);
+  std::vector<std::byte> data =
+      random_bytes(_EXT_BASE64_PARALLEL_MIN_SIZE_ + 1, 3);
+  std::string encoded = ext::base64::encode(data);
+
+  // Line-wrapped text is decoded serially.
+  std::string wrapped;
+  for (size_t i = 0; i < encoded.size(); i += 76)
+    wrapped.append(encoded, i, 76).append("\r\n");
+  EXPECT_EQ(ext::base64::decode_parallel(pool, wrapped, 4), data);
+
+  // A line break past the first kilobyte lands in one of the chunks.
+  std::string late = encoded;
+  late.insert(late.size() / 2, "\n\n\n\n");
+  EXPECT_EQ(ext::base64::decode_parallel(pool, late, 4), data);
+
+  // Errors are those of decode_into, wherever they are.
+  std::string padded = encoded;
+  padded[padded.size() / 4 / 4 * 4 + 2] = '=';
+  padded[padded.size() / 4 / 4 * 4 + 3] = '=';
+  EXPECT_THROW(ext::base64::decode_parallel(pool, padded, 4),
+               std::runtime_error);
+  std::string invalid = encoded;
+  invalid[invalid.size() / 2] = '*';
+  EXPECT_THROW(ext::base64::decode_parallel(pool, invalid, 4),
+               std::runtime_error);
+
+  std::vector<std::byte> small(data.size() - 1);
+  EXPECT_THROW(ext::base64::decode_parallel_into(pool, encoded.data(),
+                                                 encoded.size(), small.data(),
+                                                 small.size(), 4),
+               std::length_error);
+  std::string small_text(encoded.size() - 1, '\0');
+  EXPECT_THROW(ext::base64::encode_parallel_into(pool, data.data(), data.size(),
+                                                 &small_text[0],
+                                                 small_text.size(), 4),
+               std::length_error);
+}
+
+// Prints timings only; run it with --gtest_also_run_disabled_tests.
+TEST(base64_test, DISABLED_parallel_throughput_benchmark) {
+  unsigned int threads = std::thread::hardware_concurrency();
+  ext::thread_pool pool(threads ? threads : 1);
+  std::vector<std::byte> data = random_bytes(64 << 20, 1);
+  std::string encoded(ext::base64::encoded_size(data.size()), '\0');
+  std::vector<std::byte> decoded(data.size());
+  const int rounds = 4;
+
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r)
+    ext::base64::encode_into(data.data(), data.size(), &encoded[0],
+                             encoded.size());
+  double encode_seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r)
+    ext::base64::encode_parallel_into(pool, data.data(), data.size(),
+                                      &encoded[0], encoded.size());
+  double encode_parallel_seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r)
+    ext::base64::decode_into(encoded.data(), encoded.size(), decoded.data(),
+                             decoded.size());
+  double decode_seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r)
+    ext::base64::decode_parallel_into(pool, encoded.data(), encoded.size(),
+                                      decoded.data(), decoded.size());
+  double decode_parallel_seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  EXPECT_EQ(decoded, data);
+
+  double megabytes = static_cast<double>(data.size() * rounds) / (1 << 20);
+  std::cout << "base64 64 MB on " << threads << " threads: encode_into "
+            << megabytes / encode_seconds << " MB/s, encode_parallel_into "
+            << megabytes / encode_parallel_seconds << " MB/s, decode_into "
+            << megabytes / decode_seconds << " MB/s, decode_parallel_into "
+            << megabytes / decode_parallel_seconds << " MB/s\n";
+}
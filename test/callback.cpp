@@ -1,8 +1,11 @@
 #include <ext/callback>
 
 #ifdef _EXT_CALLBACK_
+#include <atomic>
 #include <functional>
 #include <gtest/gtest.h>
+#include <thread>
+#include <vector>
 
 void sum_fn(int *sum, int val) { *sum += val; }
 
@@ -65,4 +68,49 @@ TEST(callback_test, callback_args_test) {
   EXPECT_EQ(sum, 80);
 }
 #endif
+
+#ifdef __cpp_lambdas
+TEST(callback_test, callback_register_in_handler) {
+  ext::callback<int> int_callback;
+  int sum = 0;
+  ext::callback<int>::cookie inner = nullptr;
+  int_callback += [&](int val) {
+    sum += val;
+    if (inner == nullptr)
+      inner = int_callback += [&sum](int val) { sum += val * 10; };
+  };
+  int_callback(1);
+  EXPECT_EQ(sum, 1);
+
+  int_callback(1);
+  EXPECT_EQ(sum, 12);
+
+  int_callback -= inner;
+  int_callback(1);
+  EXPECT_EQ(sum, 13);
+}
+
+TEST(callback_test, callback_concurrent_invoke) {
+  ext::callback<int> int_callback;
+  std::atomic<int> sum(0);
+  int_callback += [&sum](int val) { sum += val; };
+  int_callback += [&sum](int val) { sum += val; };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.push_back(std::thread([&int_callback]() {
+      for (int j = 0; j < 1000; ++j)
+        int_callback(1);
+    }));
+  }
+  std::thread writer([&int_callback]() {
+    for (int j = 0; j < 100; ++j)
+      int_callback -= (int_callback += [](int) {});
+  });
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i].join();
+  writer.join();
+  EXPECT_EQ(sum.load(), 4 * 1000 * 2);
+}
+#endif
 #endif // _EXT_CALLBACK_
\ No newline at end of file
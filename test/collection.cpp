@@ -13,9 +13,16 @@
 #include <ext/shared_recursive_mutex>
 
 #include <ext/collection>
+#include <ext/thread_pool>
 #include <ext/typeinfo>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #ifdef _EXT_COLLECTION_
 
 class data {
@@ -305,4 +312,274 @@ TEST(collection_test, no_add) {
   count++;
   EXPECT_EQ(count, global_managed_data_list_count);
 }
+
+class dense_data;
+namespace ext {
+template <>
+struct collection_traits<dense_data> : collection_default_traits {
+  static const bool dense_storage = true;
+};
+} // namespace ext
+
+class dense_data : public ext::collection<dense_data>::item {
+public:
+  dense_data() : id(0) {}
+  int id;
+};
+
+typedef ext::collection<dense_data> dense_data_list_rw;
+typedef ext::const_collection<dense_data> dense_data_list_r;
+
+TEST(collection_test, dense_storage) {
+  EXPECT_EQ(dense_data_list_r::size(), 0);
+  {
+    std::vector<std::unique_ptr<dense_data>> items;
+    for (int i = 0; i < 100; ++i) {
+      items.push_back(std::unique_ptr<dense_data>(new dense_data));
+      items.back()->id = i;
+    }
+    EXPECT_EQ(dense_data_list_r::size(), 100);
+
+    // Remove every other item; the remaining ones are still enumerated.
+    for (size_t i = 0; i < items.size(); i += 2)
+      items[i].reset();
+    EXPECT_EQ(dense_data_list_rw::size(), 50);
+
+    int sum = 0;
+    CXX_FOR(const dense_data *item, dense_data_list_r()) {
+      EXPECT_EQ(item->id % 2, 1);
+      sum += item->id;
+    }
+    EXPECT_EQ(sum, 2500);
+
+    // Manual add/remove of an item that already lives in the collection.
+    ext::collection_mgr<dense_data> mgr;
+    mgr.add(items[1].get());
+    EXPECT_EQ(dense_data_list_r::size(), 51);
+    mgr.remove(items[1].get());
+    EXPECT_EQ(dense_data_list_r::size(), 50);
+
+    CXX_FOR(dense_data * item, dense_data_list_rw()) { item->id = -1; }
+    for (size_t i = 1; i < items.size(); i += 2)
+      EXPECT_EQ(items[i]->id, -1);
+  }
+  EXPECT_EQ(dense_data_list_r::size(), 0);
+}
+
+#if (CXX_VER >= 201103L)
+class snapshot_data : public ext::collection<snapshot_data>::item {
+public:
+  snapshot_data(int id_ = 0) : id(id_) {}
+  int id;
+};
+
+TEST(collection_test, snapshot) {
+  snapshot_data first(1);
+  snapshot_data second(2);
+
+  ext::const_collection<snapshot_data>::snapshot_type items =
+      ext::const_collection<snapshot_data>::snapshot();
+  EXPECT_TRUE((std::is_same<const snapshot_data *,
+                            decltype(items[0])>::value));
+  EXPECT_EQ(items.size(), 2);
+
+  // An unchanged collection returns the cached snapshot.
+  EXPECT_EQ(ext::collection<snapshot_data>::snapshot().version(),
+            items.version());
+
+  // Changes made after the snapshot was taken are not visible in it.
+  {
+    snapshot_data third(3);
+    EXPECT_EQ(items.size(), 2);
+    EXPECT_EQ(ext::collection<snapshot_data>::snapshot().size(), 3);
+
+    // Iterating a snapshot holds no lock, so items can be added meanwhile.
+    int sum = 0;
+    CXX_FOR(snapshot_data * item, ext::collection<snapshot_data>::snapshot()) {
+      snapshot_data temp(10);
+      sum += item->id;
+    }
+    EXPECT_EQ(sum, 6);
+  }
+  EXPECT_EQ(ext::collection<snapshot_data>::snapshot().size(), 2);
+}
+
+TEST(collection_test, snapshot_concurrent) {
+  std::vector<std::unique_ptr<snapshot_data>> items;
+  for (int i = 0; i < 100; ++i)
+    items.push_back(std::unique_ptr<snapshot_data>(new snapshot_data(i)));
+
+  std::vector<const snapshot_data *> fixed;
+  for (size_t i = 0; i < items.size(); ++i)
+    fixed.push_back(items[i].get());
+  std::sort(fixed.begin(), fixed.end());
+
+  std::atomic<bool> stop(false);
+  std::thread churn([&stop]() {
+    while (!stop) {
+      snapshot_data temp(-1);
+    }
+  });
+  // A snapshot may still hold the churned items after they were destroyed,
+  // so only compare pointers here.
+  for (int i = 0; i < 1000; ++i) {
+    size_t count = 0;
+    CXX_FOR(const snapshot_data *item,
+            ext::const_collection<snapshot_data>::snapshot()) {
+      if (std::binary_search(fixed.begin(), fixed.end(), item))
+        ++count;
+    }
+    EXPECT_EQ(count, 100);
+  }
+  stop = true;
+  churn.join();
+}
+
+TEST(collection_test, parallel_for_each) {
+  std::vector<std::unique_ptr<snapshot_data>> items;
+  for (int i = 0; i < 1000; ++i)
+    items.push_back(std::unique_ptr<snapshot_data>(new snapshot_data(i)));
+
+  ext::thread_pool pool(4);
+  std::atomic<long> sum(0);
+  ext::collection<snapshot_data>::parallel_for_each(
+      pool, [&sum](snapshot_data *item) {
+        sum += item->id;
+        item->id = -item->id;
+      });
+  EXPECT_EQ(sum.load(), 999 * 1000 / 2);
+  for (size_t i = 0; i < items.size(); ++i)
+    EXPECT_EQ(items[i]->id, -static_cast<int>(i));
+
+  EXPECT_THROW(ext::collection<snapshot_data>::parallel_for_each(
+                   pool,
+                   [](snapshot_data *item) {
+                     if (item->id == -500)
+                       throw std::runtime_error("error");
+                   },
+                   8),
+               std::runtime_error);
+}
+
+class buffered_data;
+namespace ext {
+template <>
+struct collection_traits<buffered_data> : collection_default_traits {
+  static const bool dense_storage = true;
+  static const bool buffered_registration = true;
+};
+} // namespace ext
+
+class buffered_data : public ext::collection<buffered_data>::item {
+public:
+  buffered_data(int id_ = 0) : id(id_) {}
+  int id;
+};
+
+TEST(collection_test, buffered_registration) {
+  EXPECT_EQ(ext::const_collection<buffered_data>::size(), 0);
+  {
+    buffered_data first(1);
+    buffered_data second(2);
+    EXPECT_EQ(ext::const_collection<buffered_data>::size(), 2);
+
+    int sum = 0;
+    CXX_FOR(const buffered_data *item, ext::const_collection<buffered_data>())
+    sum += item->id;
+    EXPECT_EQ(sum, 3);
+  }
+  EXPECT_EQ(ext::collection<buffered_data>::size(), 0);
+
+  // Items created on one thread and destroyed on another.
+  std::vector<buffered_data *> items;
+  std::thread creator([&items]() {
+    for (int i = 0; i < 100; ++i)
+      items.push_back(new buffered_data(i));
+  });
+  creator.join();
+  std::thread destroyer([&items]() {
+    for (size_t i = 0; i < items.size(); i += 2)
+      delete items[i];
+  });
+  destroyer.join();
+  EXPECT_EQ(ext::collection<buffered_data>::snapshot().size(), 50);
+  for (size_t i = 1; i < items.size(); i += 2)
+    delete items[i];
+  EXPECT_EQ(ext::collection<buffered_data>::size(), 0);
+}
+
+TEST(collection_test, buffered_registration_limit) {
+  // Filling the buffer while this thread holds a view must not wait for the
+  // collection lock.
+  std::vector<buffered_data *> items;
+  {
+    ext::const_collection<buffered_data> view;
+    for (int i = 0; i < 3000; ++i)
+      items.push_back(new buffered_data(i));
+  }
+  // Past the limit the buffer is merged without a view being created.
+  for (int i = 0; i < 3000; ++i)
+    items.push_back(new buffered_data(i));
+  EXPECT_EQ(ext::collection<buffered_data>::size(), 6000);
+
+  // Destroy the oldest items first.
+  for (size_t i = 0; i < items.size(); ++i)
+    delete items[i];
+  EXPECT_EQ(ext::collection<buffered_data>::size(), 0);
+}
+
+TEST(collection_test, buffered_registration_inside_view) {
+  // Merging from inside a view must not wait for the exclusive lock, so the
+  // item created here only shows up once the view is released.
+  buffered_data *item = nullptr;
+  {
+    ext::const_collection<buffered_data> view;
+    item = new buffered_data(1);
+    EXPECT_EQ(ext::const_collection<buffered_data>::size(), 0);
+    {
+      ext::const_collection<buffered_data> nested;
+      EXPECT_EQ(ext::const_collection<buffered_data>::snapshot().size(), 0);
+    }
+  }
+  EXPECT_EQ(ext::const_collection<buffered_data>::size(), 1);
+  delete item;
+  EXPECT_EQ(ext::const_collection<buffered_data>::size(), 0);
+}
+
+TEST(collection_test, buffered_registration_churn) {
+  buffered_data fixed(1);
+  std::atomic<bool> stop(false);
+  std::vector<std::thread> threads;
+  std::vector<buffered_data *> handoff[4];
+  for (int t = 0; t < 4; ++t) {
+    threads.push_back(std::thread([&stop, &handoff, t]() {
+      while (!stop) {
+        buffered_data temp(0);
+        handoff[t].push_back(new buffered_data(0));
+        if (handoff[t].size() > 16) {
+          delete handoff[t].front();
+          handoff[t].erase(handoff[t].begin());
+        }
+      }
+      for (size_t i = 0; i < handoff[t].size(); ++i)
+        delete handoff[t][i];
+      handoff[t].clear();
+    }));
+  }
+  // Items of other threads may be destroyed while pending in their buffers,
+  // so only compare pointers here.
+  for (int i = 0; i < 200; ++i) {
+    int found = 0;
+    CXX_FOR(const buffered_data *item, ext::const_collection<buffered_data>()) {
+      if (item == &fixed)
+        ++found;
+    }
+    EXPECT_EQ(found, 1);
+  }
+  stop = true;
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i].join();
+  EXPECT_EQ(ext::collection<buffered_data>::size(), 1);
+}
+#endif
 #endif // _EXT_COLLECTION_
\ No newline at end of file
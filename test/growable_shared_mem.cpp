@@ -0,0 +1,68 @@
+#include <ext/growable_shared_mem>
+#include <gtest/gtest.h>
+
+#ifdef _EXT_GROWABLE_SHARED_MEM_
+#include <cstring>
+#include <string>
+
+#include <unistd.h>
+
+#include "ipc_test_utils.h"
+
+TEST(growable_shared_mem_test, grow_and_refresh) {
+  std::string name = unique_name("growable_shared_mem_grow");
+  ext::growable_shared_mem owner(name.c_str(), 100);
+  EXPECT_TRUE(owner.created());
+  EXPECT_EQ(owner.size(), get_page_size());
+  EXPECT_EQ(owner.generation(), 0u);
+  strcpy(static_cast<char *>(owner.data()), "hello");
+
+  ext::growable_shared_mem reader(name.c_str(), 0);
+  EXPECT_FALSE(reader.created());
+  EXPECT_EQ(reader.size(), get_page_size());
+  EXPECT_STREQ(static_cast<char *>(reader.data()), "hello");
+
+  size_t new_size = 16 * 1024 * 1024;
+  char *data = static_cast<char *>(owner.grow(new_size));
+  EXPECT_EQ(owner.generation(), 1u);
+  EXPECT_EQ(owner.size(), new_size);
+  EXPECT_STREQ(data, "hello");
+  strcpy(data + new_size - 6, "world");
+
+  // Growing to a smaller size does nothing.
+  owner.grow(100);
+  EXPECT_EQ(owner.generation(), 1u);
+
+  // The reader remaps on its next access.
+  EXPECT_EQ(reader.generation(), 0u);
+  EXPECT_EQ(reader.size(), new_size);
+  EXPECT_EQ(reader.generation(), 1u);
+  EXPECT_STREQ(static_cast<char *>(reader.data()) + new_size - 6, "world");
+  EXPECT_FALSE(reader.refresh());
+
+  EXPECT_TRUE(owner.unlink());
+}
+
+TEST(growable_shared_mem_test, grow_from_other_process) {
+  std::string name = unique_name("growable_shared_mem_fork");
+  ext::growable_shared_mem segment(name.c_str(), 4096);
+  size_t new_size = 4 * 1024 * 1024;
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+  if (pid == 0) {
+    ext::growable_shared_mem child(name.c_str(), 0);
+    char *data = static_cast<char *>(child.grow(new_size));
+    memset(data, 'x', new_size);
+    _exit(child.size() == new_size ? 0 : 1);
+  }
+  EXPECT_EQ(wait_child(pid), 0);
+
+  EXPECT_TRUE(segment.refresh());
+  ASSERT_EQ(segment.size(), new_size);
+  const char *data = static_cast<const char *>(segment.data());
+  EXPECT_EQ(data[0], 'x');
+  EXPECT_EQ(data[new_size - 1], 'x');
+  EXPECT_TRUE(segment.unlink());
+}
+#endif // _EXT_GROWABLE_SHARED_MEM_
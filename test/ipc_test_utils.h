@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * @brief Returns a name for a named object that is unique to this test
+ * process, so that concurrent test runs do not share objects.
+ */
+inline std::string unique_name(const char *prefix) {
+  return std::string(prefix) + std::to_string(getpid());
+}
+
+/**
+ * @brief Waits for a forked child and returns its exit code, or -1 when it did
+ * not exit normally.
+ */
+inline int wait_child(pid_t pid) {
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
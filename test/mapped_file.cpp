@@ -0,0 +1,119 @@
+#include <ext/mapped_file>
+#include <gtest/gtest.h>
+
+#if defined(_EXT_MAPPED_FILE_) && !defined(_WIN32)
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include <unistd.h>
+
+namespace {
+std::string temp_path(const char *prefix) {
+  return std::string("/tmp/") + prefix + std::to_string(getpid());
+}
+
+std::string read_file(const std::string &path) {
+  std::ifstream in(path.c_str(), std::ios::binary);
+  return std::string((std::istreambuf_iterator<char>(in)),
+                     std::istreambuf_iterator<char>());
+}
+
+void write_file(const std::string &path, const std::string &content) {
+  std::ofstream out(path.c_str(), std::ios::binary);
+  out << content;
+}
+
+std::string pattern(size_t size) {
+  std::string content(size, '\0');
+  for (size_t i = 0; i < size; ++i)
+    content[i] = static_cast<char>('a' + i % 26);
+  return content;
+}
+} // namespace
+
+TEST(mapped_file_test, read_only) {
+  std::string path = temp_path("mapped_file_read_only");
+  std::string content = pattern(10000);
+  write_file(path, content);
+
+  ext::mapped_file file(path.c_str());
+  ASSERT_TRUE(file.is_open());
+  ASSERT_TRUE(file.is_mapped());
+  EXPECT_EQ(file.file_size(), content.size());
+  ASSERT_EQ(file.size(), content.size());
+  EXPECT_EQ(memcmp(file.data(), content.data(), content.size()), 0);
+
+  file.close();
+  EXPECT_FALSE(file.is_open());
+  EXPECT_FALSE(ext::mapped_file("/nonexistent/mapped_file").is_open());
+  remove(path.c_str());
+}
+
+TEST(mapped_file_test, window) {
+  std::string path = temp_path("mapped_file_window");
+  std::string content = pattern(5 * get_page_size() + 123);
+  write_file(path, content);
+
+  ext::mapped_file file;
+  ASSERT_TRUE(file.open(path.c_str()));
+  EXPECT_FALSE(file.is_mapped());
+
+  // Offsets do not have to be page aligned.
+  unsigned long long offset = get_page_size() * 2 + 100;
+  ASSERT_TRUE(file.map(offset, 300));
+  EXPECT_EQ(file.offset(), offset);
+  EXPECT_EQ(file.size(), 300u);
+  EXPECT_EQ(std::string(static_cast<const char *>(file.data()), 300),
+            content.substr(static_cast<size_t>(offset), 300));
+
+  // Without a length, the window ends at the end of the file.
+  ASSERT_TRUE(file.map(content.size() - 50));
+  EXPECT_EQ(file.size(), 50u);
+  EXPECT_EQ(std::string(static_cast<const char *>(file.data()), 50),
+            content.substr(content.size() - 50));
+
+  EXPECT_FALSE(file.map(content.size() - 10, 20));
+  EXPECT_FALSE(file.map(content.size() + 1));
+  remove(path.c_str());
+}
+
+TEST(mapped_file_test, copy_on_write) {
+  std::string path = temp_path("mapped_file_cow");
+  std::string content = pattern(4096);
+  write_file(path, content);
+  {
+    ext::mapped_file file(path.c_str(), mapped_file_copy_on_write);
+    ASSERT_TRUE(file.is_mapped());
+    char *data = static_cast<char *>(file.data());
+    memcpy(data, "private", 7);
+    EXPECT_EQ(memcmp(data, "private", 7), 0);
+    EXPECT_TRUE(file.sync());
+  }
+  EXPECT_EQ(read_file(path), content);
+  remove(path.c_str());
+}
+
+TEST(mapped_file_test, read_write) {
+  std::string path = temp_path("mapped_file_read_write");
+  remove(path.c_str());
+
+  ext::mapped_file file;
+  ASSERT_TRUE(file.open(path.c_str(), mapped_file_read_write));
+  EXPECT_EQ(file.file_size(), 0u);
+  ASSERT_TRUE(file.resize(3 * get_page_size()));
+  ASSERT_TRUE(file.map(get_page_size() + 10, 5));
+  memcpy(file.data(), "hello", 5);
+  EXPECT_TRUE(file.sync());
+  EXPECT_TRUE(file.sync(0, 5, false));
+  EXPECT_FALSE(file.sync(3, 5));
+
+  std::string stored = read_file(path);
+  ASSERT_EQ(stored.size(), 3 * get_page_size());
+  EXPECT_EQ(stored.substr(get_page_size() + 10, 5), "hello");
+  EXPECT_EQ(stored[0], '\0');
+  file.close();
+  remove(path.c_str());
+}
+#endif // defined(_EXT_MAPPED_FILE_) && !defined(_WIN32)
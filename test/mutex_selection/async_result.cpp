@@ -0,0 +1,28 @@
+#include "mutex_selection.h"
+
+#include <ext/async_result>
+#include <gtest/gtest.h>
+
+#if defined(_EXT_ASYNC_RESULT_) && defined(_EXT_ADAPTIVE_MUTEX_) &&          \
+    defined(__cpp_lambdas)
+#include <type_traits>
+#include <utility>
+
+TEST(mutex_selection_test, async_result_adaptive_mutex) {
+  typedef ext::async_result<int> int_result;
+  EXPECT_TRUE(
+      (std::is_same<decltype(std::declval<
+                             ext::async_iterator<int>::context>()
+                                 .mtx),
+                    ext::adaptive_mutex>::value));
+  int_result res([](int_result::context &ctx) {
+    ctx.begin(100);
+    for (int i = 1; i <= 100; ++i)
+      ctx.push(i);
+    ctx.end();
+  });
+  int expected = 1;
+  CXX_FOR(int &value, res) { EXPECT_EQ(value, expected++); }
+  EXPECT_EQ(expected, 101);
+}
+#endif // defined(_EXT_ASYNC_RESULT_) && defined(_EXT_ADAPTIVE_MUTEX_) && ...
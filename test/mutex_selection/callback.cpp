@@ -0,0 +1,37 @@
+#include "mutex_selection.h"
+
+#include <ext/callback>
+#include <gtest/gtest.h>
+
+#if defined(_EXT_CALLBACK_) && defined(_EXT_ADAPTIVE_MUTEX_)
+#include <atomic>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+TEST(mutex_selection_test, callback_adaptive_mutex) {
+  EXPECT_TRUE((std::is_same<ext::callback<int>::mutex_type,
+                            ext::adaptive_mutex>::value));
+  ext::callback<int> callback;
+  std::atomic<long> sum(0);
+  ext::callback<int>::cookie cookie =
+      callback += [&sum](int value) { sum += value; };
+
+  // Registration from several threads serializes on the adaptive mutex.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.push_back(std::thread([&callback]() {
+      for (int i = 0; i < 100; ++i)
+        callback -= (callback += [](int) {});
+    }));
+  }
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i].join();
+
+  callback(5);
+  EXPECT_EQ(sum.load(), 5);
+  callback -= cookie;
+  callback(5);
+  EXPECT_EQ(sum.load(), 5);
+}
+#endif // defined(_EXT_CALLBACK_) && defined(_EXT_ADAPTIVE_MUTEX_)
@@ -0,0 +1,40 @@
+#include "mutex_selection.h"
+
+#include <ext/collection>
+#include <gtest/gtest.h>
+
+#if defined(_EXT_COLLECTION_) && defined(_EXT_SHARDED_SHARED_MUTEX_)
+#include <chrono>
+#include <thread>
+#include <type_traits>
+
+namespace {
+class sharded_item : public ext::collection<sharded_item>::item {};
+} // namespace
+
+TEST(mutex_selection_test, collection_sharded_shared_mutex) {
+  EXPECT_TRUE((std::is_same<ext::collection<sharded_item>::mutex_type,
+                            ext::sharded_shared_mutex>::value));
+  sharded_item first;
+  sharded_item second;
+  EXPECT_EQ(ext::const_collection<sharded_item>::size(), 2);
+
+  // A nested shared view must not wait for a writer (a thread adding an item)
+  // that is waiting for the outer view to be released.
+  std::thread writer;
+  {
+    ext::const_collection<sharded_item> outer;
+    writer = std::thread([]() { sharded_item temp; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    size_t count = 0;
+    CXX_FOR(const sharded_item *item, outer) {
+      if (item == &first || item == &second)
+        ++count;
+    }
+    EXPECT_EQ(count, 2);
+    EXPECT_EQ(ext::const_collection<sharded_item>::size(), 2);
+  }
+  writer.join();
+  EXPECT_EQ(ext::const_collection<sharded_item>::size(), 2);
+}
+#endif // defined(_EXT_COLLECTION_) && defined(_EXT_SHARDED_SHARED_MUTEX_)
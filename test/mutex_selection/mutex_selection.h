@@ -0,0 +1,23 @@
+/**
+ * @file mutex_selection.h
+ * @brief Mutex selection of the mutex_selection test program.
+ *
+ * The module mutex macros must be defined the same way in every translation
+ * unit of a program, so every source of this program includes this header
+ * before any ext header. (The main unittest program keeps the defaults.)
+ */
+#pragma once
+
+#include <ext/adaptive_mutex>
+#include <ext/sharded_shared_mutex>
+
+#ifdef _EXT_ADAPTIVE_MUTEX_
+#define _EXT_THREAD_POOL_MUTEX_ ext::adaptive_mutex
+#define _EXT_CALLBACK_MUTEX_ ext::adaptive_mutex
+#define _EXT_ASYNC_RESULT_MUTEX_ ext::adaptive_mutex
+#endif
+
+#ifdef _EXT_SHARDED_SHARED_MUTEX_
+#define _EXT_COLLECTION_MUTEX_ ext::sharded_shared_mutex
+#define __OBSERVABLE_SHARED_MUTEX__ ext::sharded_shared_mutex
+#endif
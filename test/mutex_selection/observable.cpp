@@ -0,0 +1,70 @@
+#include "mutex_selection.h"
+
+#include <ext/property>
+#include <gtest/gtest.h>
+
+#if defined(_EXT_PROPERTY_) && defined(_EXT_SHARDED_SHARED_MUTEX_)
+#include <chrono>
+#include <thread>
+
+namespace {
+class counter : public ext::observable<ext::property<int>, int>::observer {
+public:
+  counter() : count(0) {}
+  int count;
+
+private:
+  void update(ext::property<int> &, int) override { ++count; }
+};
+
+/**
+ * While a notifies it, starts a thread that subscribes to a (and so waits
+ * for the exclusive lock), and then lets the nested notification of b run.
+ */
+class contender : public ext::observable<ext::property<int>, int>::observer {
+public:
+  contender(ext::property<int> &a, ext::property<int> &b) : a_(a), b_(b) {}
+
+  void join() {
+    if (thread_.joinable())
+      thread_.join();
+  }
+
+  counter late;
+
+private:
+  void update(ext::property<int> &, int value) override {
+    ext::property<int> &a = a_;
+    counter &late_counter = late;
+    thread_ = std::thread([&a, &late_counter]() { late_counter += a; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    b_ = value * 2;
+  }
+
+  ext::property<int> &a_;
+  ext::property<int> &b_;
+  std::thread thread_;
+};
+} // namespace
+
+TEST(mutex_selection_test, observable_sharded_shared_mutex) {
+  // b notifies c from inside the notification of a, which takes a nested
+  // shared lock while another thread waits for the exclusive lock.
+  ext::property<int> a(0);
+  ext::property<int> b(0);
+  ext::property<int> c(0);
+  c = b + 1;
+  contender observer(a, b);
+  observer += a;
+
+  a = 1;
+  observer.join();
+  EXPECT_EQ(b.value(), 2);
+  EXPECT_EQ(c.value(), 3);
+
+  a = 2;
+  observer.join();
+  EXPECT_EQ(c.value(), 5);
+  EXPECT_EQ(observer.late.count, 1);
+}
+#endif // defined(_EXT_PROPERTY_) && defined(_EXT_SHARDED_SHARED_MUTEX_)
@@ -0,0 +1,29 @@
+#include "mutex_selection.h"
+
+#include <ext/thread_pool>
+#include <gtest/gtest.h>
+
+#if defined(_EXT_THREAD_POOL_) && defined(_EXT_ADAPTIVE_MUTEX_)
+#include <future>
+#include <type_traits>
+#include <vector>
+
+TEST(mutex_selection_test, thread_pool_adaptive_mutex) {
+  EXPECT_TRUE((std::is_same<ext::thread_pool::mutex_type,
+                            ext::adaptive_mutex>::value));
+  ext::thread_pool pool(4);
+  std::vector<std::future<int>> results;
+  for (int i = 0; i < 1000; ++i)
+    results.push_back(pool.queue([i]() { return i; }));
+  long long sum = 0;
+  for (size_t i = 0; i < results.size(); ++i)
+    sum += results[i].get();
+  EXPECT_EQ(sum, 999 * 1000 / 2);
+
+  ext::thread_pool::queue_item<void> item = pool.queue_cancellable([]() {});
+  item.get_future().wait();
+  EXPECT_FALSE(item.cancel());
+  pool.stop();
+  EXPECT_EQ(pool.status(), ext::thread_pool::stopped);
+}
+#endif // defined(_EXT_THREAD_POOL_) && defined(_EXT_ADAPTIVE_MUTEX_)
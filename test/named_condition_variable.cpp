@@ -0,0 +1,75 @@
+#include <ext/named_condition_variable>
+#include <gtest/gtest.h>
+
+#ifdef _EXT_NAMED_CONDITION_VARIABLE_
+#include <ext/named_shared_mutex>
+#include <ext/shared_mem>
+
+#include <chrono>
+#include <mutex>
+#include <string>
+
+#include <unistd.h>
+
+#include "ipc_test_utils.h"
+
+namespace {
+struct named_condition_variable_data {
+  named_condition_variable_data() : ready(false) {}
+  ext::robust_mutex mutex;
+  bool ready;
+};
+} // namespace
+
+TEST(named_condition_variable_test, notify_across_processes) {
+  std::string name = unique_name("named_condition_variable_notify");
+  ext::named_condition_variable cv(name.c_str());
+  ext::shared_mem<named_condition_variable_data> data(
+      unique_name("named_condition_variable_data").c_str(),
+      shared_mem_all_access);
+  ASSERT_TRUE(data.created());
+  ASSERT_NE(data(), (named_condition_variable_data *)nullptr);
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+  if (pid == 0) {
+    ext::named_condition_variable child(name.c_str());
+    std::unique_lock<ext::robust_mutex> lock(data->mutex);
+    bool ready = child.wait_for(lock, std::chrono::seconds(10),
+                                [&data]() { return data->ready; });
+    _exit(ready ? 0 : 1);
+  }
+
+  {
+    std::lock_guard<ext::robust_mutex> lock(data->mutex);
+    data->ready = true;
+  }
+  cv.notify_all();
+  EXPECT_EQ(wait_child(pid), 0);
+
+  data.destroy();
+  EXPECT_TRUE(cv.unlink());
+}
+
+TEST(named_condition_variable_test, wait_for_timeout) {
+  std::string name = unique_name("named_condition_variable_timeout");
+  ext::named_condition_variable cv(name.c_str());
+  ext::named_shared_mutex mutex(
+      unique_name("named_condition_variable_mutex").c_str());
+
+  std::unique_lock<ext::named_shared_mutex> lock(mutex);
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  EXPECT_EQ(cv.wait_for(lock, std::chrono::milliseconds(20)),
+            std::cv_status::timeout);
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(20));
+  EXPECT_TRUE(lock.owns_lock());
+  EXPECT_FALSE(cv.wait_for(lock, std::chrono::milliseconds(1),
+                           []() { return false; }));
+  lock.unlock();
+
+  EXPECT_TRUE(mutex.unlink());
+  EXPECT_TRUE(cv.unlink());
+}
+#endif // _EXT_NAMED_CONDITION_VARIABLE_
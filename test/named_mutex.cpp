@@ -3,6 +3,7 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -17,6 +18,53 @@ std::string unique_mutex_name() {
   return "enm" + std::to_string(stamp) + "_" +
          std::to_string(counter.fetch_add(1));
 }
+
+// Holds the lock of a mutex on a thread of its own. (Windows mutexes are
+// recursive per thread and can only be released by the thread that owns them,
+// so the owner and the contender must lock from different threads.)
+class lock_holder {
+public:
+  explicit lock_holder(ext::named_mutex &mutex)
+      : mutex_(mutex), locked_(false), released_(false), delay_(0) {
+    thread_ = std::thread([this]() {
+      mutex_.lock();
+      std::unique_lock<std::mutex> lock(state_mutex_);
+      locked_ = true;
+      cv_.notify_all();
+      cv_.wait(lock, [this]() { return released_; });
+      lock.unlock();
+      if (delay_.count())
+        std::this_thread::sleep_for(delay_);
+      mutex_.unlock();
+    });
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    cv_.wait(lock, [this]() { return locked_; });
+  }
+
+  ~lock_holder() {
+    release();
+    thread_.join();
+  }
+
+  // Unlocks the mutex after the delay, without waiting for it.
+  void release(std::chrono::milliseconds delay = std::chrono::milliseconds(0)) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    if (released_)
+      return;
+    delay_ = delay;
+    released_ = true;
+    cv_.notify_all();
+  }
+
+private:
+  ext::named_mutex &mutex_;
+  std::mutex state_mutex_;
+  std::condition_variable cv_;
+  bool locked_;
+  bool released_;
+  std::chrono::milliseconds delay_;
+  std::thread thread_;
+};
 } // namespace
 
 TEST(named_mutex_test, locks_across_instances) {
@@ -60,4 +108,67 @@ TEST(named_mutex_test, lock_guard_compatible) {
 
   EXPECT_TRUE(mutex.unlink());
 }
+
+TEST(named_mutex_test, try_lock_for) {
+  std::string name = unique_mutex_name();
+  ext::named_mutex owner(name.c_str());
+  ext::named_mutex contender(name.c_str());
+
+  {
+    lock_holder holder(owner);
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    EXPECT_FALSE(contender.try_lock_for(std::chrono::milliseconds(20)));
+    EXPECT_GE(std::chrono::steady_clock::now() - start,
+              std::chrono::milliseconds(20));
+    EXPECT_FALSE(contender.try_lock_until(std::chrono::system_clock::now()));
+
+    holder.release(std::chrono::milliseconds(20));
+    EXPECT_TRUE(contender.try_lock_for(std::chrono::seconds(10)));
+  }
+  contender.unlock();
+
+  EXPECT_TRUE(owner.unlink());
+}
+
+TEST(named_mutex_test, statistics) {
+  std::string name = unique_mutex_name();
+  ext::named_mutex owner(name.c_str());
+  ext::named_mutex mutex(name.c_str(), true);
+
+  mutex.lock();
+  mutex.unlock();
+  EXPECT_TRUE(mutex.try_lock());
+  mutex.unlock();
+
+  ext::named_mutex_statistics stats = mutex.statistics();
+  EXPECT_EQ(stats.acquisitions, 2u);
+  EXPECT_EQ(stats.contended_acquisitions, 0u);
+
+  {
+    // A timed wait that gives up adds wait time but no acquisition.
+    lock_holder holder(owner);
+    EXPECT_FALSE(mutex.try_lock_for(std::chrono::milliseconds(10)));
+    stats = mutex.statistics();
+    EXPECT_EQ(stats.acquisitions, 2u);
+    EXPECT_GE(stats.wait_time, std::chrono::milliseconds(10));
+
+    holder.release(std::chrono::milliseconds(10));
+    mutex.lock();
+  }
+  mutex.unlock();
+
+  stats = mutex.statistics();
+  EXPECT_EQ(stats.acquisitions, 3u);
+  EXPECT_EQ(stats.contended_acquisitions, 1u);
+
+  // Instances without statistics do not count.
+  EXPECT_EQ(owner.statistics().acquisitions, 0u);
+
+  mutex.reset_statistics();
+  EXPECT_EQ(mutex.statistics().acquisitions, 0u);
+  EXPECT_EQ(mutex.statistics().wait_time.count(), 0);
+
+  EXPECT_TRUE(owner.unlink());
+}
 #endif
@@ -0,0 +1,76 @@
+#include <ext/named_shared_mutex>
+#include <gtest/gtest.h>
+
+#ifdef _EXT_NAMED_SHARED_MUTEX_
+#include <ext/shared_mem>
+
+#include <chrono>
+#include <mutex>
+#include <string>
+
+#include <unistd.h>
+
+#include "ipc_test_utils.h"
+
+TEST(named_shared_mutex_test, readers_share_across_processes) {
+  std::string name = unique_name("named_shared_mutex_readers");
+  ext::named_shared_mutex mutex(name.c_str());
+
+  mutex.lock_shared();
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+  if (pid == 0) {
+    ext::named_shared_mutex child(name.c_str());
+    int result = 0;
+    // Another reader gets in while the parent holds a shared lock.
+    if (!child.try_lock_shared_for(std::chrono::seconds(5)))
+      result |= 1;
+    else
+      child.unlock_shared();
+    // A writer does not.
+    if (child.try_lock())
+      result |= 2;
+    if (child.try_lock_for(std::chrono::milliseconds(10)))
+      result |= 4;
+    _exit(result);
+  }
+  EXPECT_EQ(wait_child(pid), 0);
+  mutex.unlock_shared();
+
+  EXPECT_TRUE(mutex.try_lock());
+  EXPECT_FALSE(mutex.try_lock_shared());
+  mutex.unlock();
+
+  EXPECT_TRUE(mutex.unlink());
+}
+
+TEST(named_shared_mutex_test, writers_exclude_across_processes) {
+  std::string name = unique_name("named_shared_mutex_writers");
+  ext::named_shared_mutex mutex(name.c_str());
+  ext::shared_mem<int> counter(
+      unique_name("named_shared_mutex_counter").c_str(), shared_mem_all_access);
+  ASSERT_TRUE(counter.created());
+  ASSERT_NE(counter(), (int *)nullptr);
+
+  const int iterations = 10000;
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+  if (pid == 0) {
+    ext::named_shared_mutex child(name.c_str());
+    for (int i = 0; i < iterations; ++i) {
+      std::lock_guard<ext::named_shared_mutex> lock(child);
+      ++*counter;
+    }
+    _exit(0);
+  }
+  for (int i = 0; i < iterations; ++i) {
+    std::lock_guard<ext::named_shared_mutex> lock(mutex);
+    ++*counter;
+  }
+  EXPECT_EQ(wait_child(pid), 0);
+  EXPECT_EQ(*counter, iterations * 2);
+
+  counter.destroy();
+  EXPECT_TRUE(mutex.unlink());
+}
+#endif // _EXT_NAMED_SHARED_MUTEX_
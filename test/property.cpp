@@ -1,6 +1,8 @@
 ﻿#include <ext/property>
 #include <gtest/gtest.h>
 
+#include <stdexcept>
+
 #ifdef _EXT_PROPERTY_
 class dialog {
 public:
@@ -112,4 +114,213 @@ TEST(property_test, basic_test) {
   users[1].count = 20;
   EXPECT_EQ(dlg.total.value(), 30);
 }
-#endif // _EXT_PROPERTY_
\ No newline at end of file
+#endif // _EXT_PROPERTY_
+#ifdef _EXT_PROPERTY_
+class update_counter
+    : public ext::observable<ext::property<int>, int>::observer {
+public:
+  update_counter() : count(0), last(0) {}
+  int count;
+  int last;
+
+private:
+  void update(ext::property<int> &, int value) override {
+    ++count;
+    last = value;
+  }
+};
+
+TEST(property_test, batch_test) {
+  ext::property<int> x(0);
+  ext::property<int> y(0);
+  ext::property<int> sum(0);
+  update_counter counter;
+  counter += x;
+  counter += y;
+  sum = x + y;
+
+  {
+    ext::property_batch batch;
+    EXPECT_TRUE(ext::property_batch::active());
+    for (int i = 1; i <= 10; ++i) {
+      x = i;
+      y = i * 2;
+    }
+    EXPECT_EQ(x.value(), 10);
+    EXPECT_EQ(counter.count, 0);
+    EXPECT_EQ(sum.value(), 0);
+
+    {
+      ext::property_batch nested;
+      x = 11;
+    }
+    EXPECT_EQ(counter.count, 0);
+  }
+  EXPECT_FALSE(ext::property_batch::active());
+  // One notification per observer, from the last property it observes.
+  EXPECT_EQ(counter.count, 1);
+  EXPECT_EQ(counter.last, 20);
+  EXPECT_EQ(sum.value(), 31);
+
+  x = 1;
+  EXPECT_EQ(counter.count, 2);
+  EXPECT_EQ(sum.value(), 21);
+}
+
+TEST(property_test, batch_destroyed_property_test) {
+  ext::property<int> x(0);
+  update_counter counter;
+  counter += x;
+
+  {
+    ext::property_batch batch;
+    x = 1;
+    {
+      ext::property<int> temp(0);
+      counter += temp;
+      temp = 2;
+    }
+    ext::property<int> *bound = new ext::property<int>(0);
+    *bound = x + 1;
+    x = 3;
+    delete bound;
+
+    update_counter *removed = new update_counter;
+    *removed += x;
+    x = 4;
+    delete removed;
+  }
+  EXPECT_EQ(counter.count, 1);
+  EXPECT_EQ(counter.last, 4);
+}
+
+class throwing_observer
+    : public ext::observable<ext::property<int>, int>::observer {
+private:
+  void update(ext::property<int> &, int) override {
+    throw std::runtime_error("error");
+  }
+};
+
+TEST(property_test, batch_exception_test) {
+  ext::property<int> x(0);
+  ext::property<int> y(0);
+  throwing_observer thrower;
+  update_counter counter;
+  thrower += x;
+  counter += y;
+
+  // Every notification is sent, and then the first exception is rethrown.
+  {
+    ext::property_batch batch;
+    x = 1;
+    y = 2;
+    EXPECT_THROW(batch.commit(), std::runtime_error);
+    EXPECT_FALSE(ext::property_batch::active());
+  }
+  EXPECT_EQ(counter.count, 1);
+
+  // Committing from the destructor discards the exception.
+  EXPECT_NO_THROW({
+    ext::property_batch batch;
+    x = 3;
+    y = 4;
+  });
+  EXPECT_EQ(counter.count, 2);
+  EXPECT_EQ(counter.last, 4);
+}
+#endif // _EXT_PROPERTY_
+
+#ifdef _EXT_PROPERTY_
+TEST(property_test, expression_test) {
+  ext::property<int> a(0);
+  ext::property<int> b(1);
+  ext::property<int> c(2);
+  update_counter counter;
+  counter += a;
+
+  a = b + c + 5;
+  EXPECT_TRUE((std::is_same<decltype(b + c + 5),
+                            ext::property_expression<
+                                int, ext::property_binary_expr<
+                                         int,
+                                         ext::property_binary_expr<
+                                             int, ext::property_ref_expr<int>,
+                                             ext::property_ref_expr<int>,
+                                             std::plus<int>>,
+                                         ext::property_value_expr<int>,
+                                         std::plus<int>>>>::value));
+  EXPECT_EQ(a.value(), 8);
+  EXPECT_EQ(counter.count, 1);
+
+  b = 10;
+  EXPECT_EQ(a.value(), 17);
+  EXPECT_EQ(counter.count, 2);
+
+  c = 2;
+  EXPECT_EQ(counter.count, 2);
+
+  a = (b - c) * 3 / 2 + 100 - c;
+  EXPECT_EQ(a.value(), 110);
+  c = 4;
+  EXPECT_EQ(a.value(), 105);
+
+  ext::property<std::string> first(std::string("Jung-kwang"));
+  ext::property<std::string> last(std::string("Lee"));
+  ext::property<std::string> full;
+  full = std::string("name : ") + first + " " + last;
+  EXPECT_STREQ(full.value().c_str(), "name : Jung-kwang Lee");
+  last = "Kim";
+  EXPECT_STREQ(full.value().c_str(), "name : Jung-kwang Kim");
+}
+
+TEST(property_test, expression_rebind_test) {
+  ext::property<int> a(0);
+  ext::property<int> b(1);
+  ext::property<int> c(2);
+
+  // Rebinding unsubscribes from the inputs of the previous expression.
+  a = b + c;
+  a = b * 10;
+  EXPECT_EQ(a.value(), 10);
+  c = 100;
+  EXPECT_EQ(a.value(), 10);
+  b = 2;
+  EXPECT_EQ(a.value(), 20);
+
+  // A plain assignment unbinds the property.
+  a = 5;
+  b = 3;
+  EXPECT_EQ(a.value(), 5);
+  c = 4;
+  EXPECT_EQ(a.value(), 5);
+
+  // A plain assignment also drops a chain.
+  a = ext::property<int>::chain(b, c);
+  EXPECT_EQ(a.value(), 7);
+  a = 1;
+  b = 10;
+  EXPECT_EQ(a.value(), 1);
+}
+
+TEST(property_test, expression_input_destroyed_test) {
+  ext::property<int> a(0);
+  ext::property<int> b(1);
+  {
+    ext::property<int> c(2);
+    a = b + c;
+    EXPECT_EQ(a.value(), 3);
+  }
+  // The binding is dropped with its input, and the last value is kept.
+  b = 10;
+  EXPECT_EQ(a.value(), 3);
+  a = b * 2;
+  EXPECT_EQ(a.value(), 20);
+
+  ext::property<int> *bound = new ext::property<int>(0);
+  *bound = a + b;
+  delete bound;
+  b = 1;
+  EXPECT_EQ(a.value(), 2);
+}
+#endif // _EXT_PROPERTY_
@@ -0,0 +1,82 @@
+#include <ext/robust_mutex>
+#include <gtest/gtest.h>
+
+#ifdef _EXT_ROBUST_MUTEX_
+#include <ext/shared_mem>
+
+#include <mutex>
+#include <string>
+
+#include <unistd.h>
+
+#include "ipc_test_utils.h"
+
+namespace {
+struct robust_mutex_data {
+  robust_mutex_data() : value(0) {}
+  ext::robust_mutex mutex;
+  int value;
+};
+} // namespace
+
+TEST(robust_mutex_test, lock_across_processes) {
+  std::string name = unique_name("robust_mutex_lock");
+  ext::shared_mem<robust_mutex_data> data(name.c_str(), shared_mem_all_access);
+  ASSERT_TRUE(data.created());
+  ASSERT_NE(data(), (robust_mutex_data *)nullptr);
+
+  EXPECT_TRUE(data->mutex.try_lock());
+  EXPECT_FALSE(data->mutex.abandoned());
+  data->mutex.unlock();
+
+  const int iterations = 10000;
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+  if (pid == 0) {
+    for (int i = 0; i < iterations; ++i) {
+      std::lock_guard<ext::robust_mutex> lock(data->mutex);
+      ++data->value;
+    }
+    _exit(0);
+  }
+  for (int i = 0; i < iterations; ++i) {
+    std::lock_guard<ext::robust_mutex> lock(data->mutex);
+    ++data->value;
+  }
+  EXPECT_EQ(wait_child(pid), 0);
+  EXPECT_EQ(data->value, iterations * 2);
+
+  data.destroy();
+}
+
+#if defined(__linux__)
+TEST(robust_mutex_test, owner_death) {
+  std::string name = unique_name("robust_mutex_death");
+  ext::shared_mem<robust_mutex_data> data(name.c_str(), shared_mem_all_access);
+  ASSERT_TRUE(data.created());
+  ASSERT_NE(data(), (robust_mutex_data *)nullptr);
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+  if (pid == 0) {
+    // Exit while holding the lock.
+    data->mutex.lock();
+    data->value = 1;
+    _exit(0);
+  }
+  EXPECT_EQ(wait_child(pid), 0);
+
+  data->mutex.lock();
+  EXPECT_TRUE(data->mutex.abandoned());
+  EXPECT_EQ(data->value, 1);
+  data->mutex.unlock();
+
+  // The mutex is consistent again.
+  data->mutex.lock();
+  EXPECT_FALSE(data->mutex.abandoned());
+  data->mutex.unlock();
+
+  data.destroy();
+}
+#endif
+#endif // _EXT_ROBUST_MUTEX_
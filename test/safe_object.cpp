@@ -5,6 +5,12 @@
 #include <ext/shared_recursive_mutex>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <vector>
+
 class test_object {
 public:
   int value;
@@ -76,4 +82,130 @@ TEST(safe_object_test, safe_object_both) {
   EXPECT_EQ(obj_t_rw.value, obj_t_rw.value);
   EXPECT_EQ(obj_t_rw.value, obj_rw.value);
 }
+
+struct test_point {
+  long long x;
+  long long y;
+};
+
+test_point point = {0, 0};
+ext::seqlock point_seq;
+
+#define point_w get_object_safety(point, point_seq, false)
+#define point_r get_object_optimistic(point, point_seq)
+
+TEST(safe_object_test, seqlock) {
+  EXPECT_TRUE((std::is_same<test_point &, decltype(point_w)>::value));
+  EXPECT_TRUE((std::is_same<test_point, decltype(point_r)>::value));
+
+  ext::seqlock::sequence_type seq = point_seq.sequence();
+  point_w.x = 10;
+  EXPECT_EQ(point_seq.sequence(), seq + 2);
+  EXPECT_EQ(point_r.x, 10);
+
+  test_point value = {1, -1};
+  point_seq.store(point, value);
+  EXPECT_EQ(point_r.y, -1);
+
+  std::atomic<bool> stop(false);
+  std::atomic<int> torn(0);
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.push_back(std::thread([&stop, &torn]() {
+      while (!stop) {
+        test_point current = point_r;
+        if (current.x != -current.y)
+          ++torn;
+      }
+    }));
+  }
+  for (long long i = 0; i < 100000; ++i) {
+    std::unique_lock<ext::seqlock> lock(point_seq);
+    point.x = i;
+    point.y = -i;
+  }
+  stop = true;
+  for (size_t i = 0; i < readers.size(); ++i)
+    readers[i].join();
+  EXPECT_EQ(torn.load(), 0);
+}
+
+test_object profiled_obj;
+std::mutex profiled_mtx;
+
+#define profiled_obj_rw                                                        \
+  (get_object_safety_with_trace(profiled_obj, profiled_mtx, false, ext::cdbg))
+
+TEST(safe_object_test, lock_profiler) {
+  ext::lock_profiler &profiler = ext::lock_profiler::instance();
+  profiler.reset();
+  profiler.enabled = true;
+
+  // A traced lock is recorded at its call site.
+  profiled_obj_rw.value = 0;
+  profiler.enabled = false;
+
+  ext::lock_profile_report report = profiler.report();
+  ASSERT_EQ(report.objects.size(), 1u);
+  EXPECT_EQ(report.objects[0].object, &profiled_obj);
+  EXPECT_EQ(report.objects[0].count, 1u);
+  ASSERT_EQ(report.sites.size(), 1u);
+  EXPECT_EQ(report.sites[0].object, &profiled_obj);
+  EXPECT_EQ(report.sites[0].mutex, &profiled_mtx);
+  EXPECT_FALSE(report.sites[0].shared);
+  EXPECT_STREQ(report.sites[0].file_name, __FILE__);
+  EXPECT_EQ(report.dropped, 0u);
+
+  std::ostringstream stream;
+  report.print(stream);
+  EXPECT_NE(stream.str().find("test_object"), std::string::npos);
+
+  profiler.reset();
+  EXPECT_TRUE(profiler.report().objects.empty());
+  EXPECT_TRUE(profiler.report().sites.empty());
+}
+
+std::string profiled_type_name() { return "profiled_type"; }
+
+TEST(safe_object_test, lock_profiler_totals) {
+  // Record known wait and hold times instead of measuring real contention.
+  ext::lock_profiler &profiler = ext::lock_profiler::instance();
+  profiler.reset();
+  profiler.contention_threshold_ns = 1000;
+  int object = 0;
+  int mutex = 0;
+  profiler.record("site.cpp", 1, &object, &mutex, profiled_type_name, false,
+                  500, 10);
+  profiler.record("site.cpp", 1, &object, &mutex, profiled_type_name, false,
+                  3000, 20);
+
+  // Records of a thread that has exited are kept in the totals.
+  std::thread worker([&profiler, &object, &mutex]() {
+    profiler.record("site.cpp", 1, &object, &mutex, profiled_type_name, false,
+                    2000, 40);
+    profiler.record("site.cpp", 2, &object, &mutex, profiled_type_name, true,
+                    100, 5);
+  });
+  worker.join();
+
+  ext::lock_profile_report report = profiler.report();
+  ASSERT_EQ(report.sites.size(), 2u);
+  const ext::lock_site_stats &site = report.sites[0];
+  EXPECT_EQ(site.line, 1);
+  EXPECT_EQ(site.object_type, "profiled_type");
+  EXPECT_EQ(site.count, 3u);
+  EXPECT_EQ(site.contended_count, 2u);
+  EXPECT_EQ(site.wait_ns, 5500u);
+  EXPECT_EQ(site.max_wait_ns, 3000u);
+  EXPECT_EQ(site.hold_ns, 70u);
+  EXPECT_EQ(site.max_hold_ns, 40u);
+  EXPECT_EQ(report.sites[1].line, 2);
+  EXPECT_TRUE(report.sites[1].shared);
+  ASSERT_EQ(report.objects.size(), 1u);
+  EXPECT_EQ(report.objects[0].count, 4u);
+  EXPECT_EQ(report.objects[0].wait_ns, 5600u);
+
+  profiler.reset();
+  EXPECT_TRUE(profiler.report().sites.empty());
+}
 #endif // _EXT_SAFE_OBJECT_
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include <ext/sharded_shared_mutex>
+#include <gtest/gtest.h>
+
+#if defined(_EXT_SHARDED_SHARED_MUTEX_)
+#include <ext/safe_object>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+TEST(sharded_shared_mutex, lock_test) {
+  ext::sharded_shared_mutex mtx;
+  mtx.lock();
+  EXPECT_FALSE(mtx.try_lock());
+  EXPECT_FALSE(mtx.try_lock_shared());
+  mtx.unlock();
+
+  mtx.lock_shared();
+  EXPECT_TRUE(mtx.try_lock_shared());
+  EXPECT_FALSE(mtx.try_lock());
+  mtx.unlock_shared();
+  mtx.unlock_shared();
+  EXPECT_TRUE(mtx.try_lock());
+  mtx.unlock();
+}
+
+TEST(sharded_shared_mutex, reentrant_shared_lock_test) {
+  // A nested shared lock must not wait for a writer that is waiting for the
+  // outer shared lock to be released.
+  ext::sharded_shared_mutex mtx;
+  std::atomic<bool> locked(false);
+  mtx.lock_shared();
+  std::thread writer([&mtx, &locked]() {
+    mtx.lock();
+    locked = true;
+    mtx.unlock();
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  mtx.lock_shared();
+  EXPECT_TRUE(mtx.try_lock_shared());
+  EXPECT_FALSE(locked);
+  mtx.unlock_shared();
+  mtx.unlock_shared();
+  EXPECT_FALSE(locked);
+  mtx.unlock_shared();
+  writer.join();
+  EXPECT_TRUE(locked);
+}
+
+TEST(sharded_shared_mutex, concurrent_test) {
+  ext::sharded_shared_mutex mtx;
+  long long first = 0;
+  long long second = 0;
+  std::atomic<bool> stop(false);
+  std::atomic<int> errors(0);
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.push_back(std::thread([&]() {
+      while (!stop) {
+        std::shared_lock<ext::sharded_shared_mutex> lock(mtx);
+        if (first != second)
+          ++errors;
+      }
+    }));
+  }
+  for (int i = 0; i < 10000; ++i) {
+    std::unique_lock<ext::sharded_shared_mutex> lock(mtx);
+    ++first;
+    ++second;
+  }
+  stop = true;
+  for (size_t i = 0; i < readers.size(); ++i)
+    readers[i].join();
+  EXPECT_EQ(errors.load(), 0);
+  EXPECT_EQ(first, 10000);
+}
+
+#ifdef _EXT_SAFE_OBJECT_
+struct sharded_config {
+  int value;
+};
+sharded_config config;
+ext::sharded_shared_mutex config_mtx;
+
+TEST(sharded_shared_mutex, safe_object_test) {
+  get_object_safety(config, config_mtx, false).value = 10;
+  EXPECT_EQ(get_object_safety(config, config_mtx, true).value, 10);
+}
+#endif // _EXT_SAFE_OBJECT_
+#endif // _EXT_SHARDED_SHARED_MUTEX_
@@ -0,0 +1,177 @@
+#include <ext/shared_hash_map>
+#include <gtest/gtest.h>
+
+#ifdef _EXT_SHARED_HASH_MAP_
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "ipc_test_utils.h"
+
+namespace {
+struct point {
+  int x;
+  int y;
+};
+} // namespace
+
+TEST(shared_hash_map_test, insert_find_erase) {
+  std::string name = unique_name("shared_hash_map_basic");
+  ext::shared_hash_map<int, point> map(name.c_str(), 100);
+  EXPECT_TRUE(map.created());
+  EXPECT_EQ(map.capacity(), 128u);
+  EXPECT_TRUE(map.empty());
+
+  point p = {1, 2};
+  EXPECT_TRUE(map.insert(7, p));
+  p.x = 3;
+  EXPECT_FALSE(map.insert(7, p));
+  point found = {0, 0};
+  ASSERT_TRUE(map.find(7, found));
+  EXPECT_EQ(found.x, 1);
+  EXPECT_EQ(found.y, 2);
+  EXPECT_FALSE(map.find(8, found));
+
+  EXPECT_FALSE(map.insert_or_assign(7, p));
+  ASSERT_TRUE(map.find(7, found));
+  EXPECT_EQ(found.x, 3);
+  EXPECT_EQ(map.size(), 1u);
+
+  EXPECT_TRUE(map.erase(7));
+  EXPECT_FALSE(map.erase(7));
+  EXPECT_FALSE(map.contains(7));
+  EXPECT_TRUE(map.insert_or_assign(7, p));
+  EXPECT_TRUE(map.contains(7));
+  EXPECT_EQ(map.size(), 1u);
+  EXPECT_TRUE(map.unlink());
+}
+
+TEST(shared_hash_map_test, full) {
+  std::string name = unique_name("shared_hash_map_full");
+  ext::shared_hash_map<int, int> map(name.c_str(), 16);
+  for (int i = 0; i < 16; ++i)
+    EXPECT_TRUE(map.insert(i, i * i));
+  EXPECT_THROW(map.insert(100, 0), std::length_error);
+  for (int i = 0; i < 16; ++i) {
+    int value = 0;
+    EXPECT_TRUE(map.find(i, value));
+    EXPECT_EQ(value, i * i);
+  }
+  EXPECT_TRUE(map.unlink());
+}
+
+TEST(shared_hash_map_test, layout_mismatch) {
+  std::string name = unique_name("shared_hash_map_layout");
+  ext::shared_hash_map<int, int> map(name.c_str(), 16);
+  typedef ext::shared_hash_map<int, point> other_map;
+  EXPECT_THROW(other_map(name.c_str(), 16), std::runtime_error);
+  EXPECT_TRUE(map.unlink());
+}
+
+TEST(shared_hash_map_test, concurrent_insert) {
+  std::string name = unique_name("shared_hash_map_threads");
+  ext::shared_hash_map<long long, long long> map(name.c_str(), 1 << 14);
+  std::atomic<int> inserted(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.push_back(std::thread([&map, &inserted]() {
+      // Every thread inserts the same keys; each key is inserted once.
+      for (long long key = 0; key < 10000; ++key) {
+        if (map.insert(key, key * 3))
+          ++inserted;
+      }
+    }));
+  }
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i].join();
+  EXPECT_EQ(inserted.load(), 10000);
+  EXPECT_EQ(map.size(), 10000u);
+  for (long long key = 0; key < 10000; ++key) {
+    long long value = 0;
+    ASSERT_TRUE(map.find(key, value));
+    EXPECT_EQ(value, key * 3);
+  }
+  EXPECT_TRUE(map.unlink());
+}
+
+TEST(shared_hash_map_test, consistent_updates) {
+  std::string name = unique_name("shared_hash_map_updates");
+  ext::shared_hash_map<int, point> map(name.c_str(), 16);
+  point p = {0, 0};
+  map.insert(1, p);
+  std::atomic<bool> done(false);
+  std::thread writer([&map, &done]() {
+    for (int i = 1; i <= 100000; ++i) {
+      point q = {i, -i};
+      map.insert_or_assign(1, q);
+    }
+    done = true;
+  });
+  // Readers never see a value that is half updated.
+  while (!done) {
+    point q;
+    ASSERT_TRUE(map.find(1, q));
+    ASSERT_EQ(q.x, -q.y);
+  }
+  writer.join();
+  EXPECT_TRUE(map.unlink());
+}
+
+TEST(shared_hash_map_test, assign_while_erasing) {
+  std::string name = unique_name("shared_hash_map_assign_erase");
+  ext::shared_hash_map<int, int> map(name.c_str(), 1 << 12);
+  std::atomic<bool> done(false);
+  std::atomic<int> erased(0);
+  std::thread eraser([&map, &done, &erased]() {
+    // Every successful erase uses up a slot, so stay below the capacity.
+    while (!done && erased < 1000) {
+      if (map.erase(1))
+        ++erased;
+    }
+  });
+  int inserted = 0;
+  for (int i = 0; i < 100000; ++i) {
+    if (map.insert_or_assign(1, i))
+      ++inserted;
+  }
+  done = true;
+  eraser.join();
+  EXPECT_EQ(inserted - erased.load(), static_cast<int>(map.size()));
+
+  // Once nothing erases, an assignment is never lost.
+  map.insert_or_assign(1, -1);
+  int value = 0;
+  ASSERT_TRUE(map.find(1, value));
+  EXPECT_EQ(value, -1);
+  EXPECT_TRUE(map.unlink());
+}
+
+TEST(shared_hash_map_test, across_processes) {
+  std::string name = unique_name("shared_hash_map_fork");
+  ext::shared_hash_map<int, int> map(name.c_str(), 1024);
+  for (int i = 0; i < 500; ++i)
+    map.insert(i, i + 1);
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+  if (pid == 0) {
+    ext::shared_hash_map<int, int> child(name.c_str(), 0);
+    if (child.created() || child.capacity() != 1024)
+      _exit(1);
+    for (int i = 0; i < 500; ++i) {
+      int value = 0;
+      if (!child.find(i, value) || value != i + 1)
+        _exit(2);
+    }
+    child.insert(1000, 42);
+    _exit(0);
+  }
+  EXPECT_EQ(wait_child(pid), 0);
+  int value = 0;
+  EXPECT_TRUE(map.find(1000, value));
+  EXPECT_EQ(value, 42);
+  EXPECT_TRUE(map.unlink());
+}
+#endif // _EXT_SHARED_HASH_MAP_
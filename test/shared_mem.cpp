@@ -63,4 +63,169 @@ TEST(shared_mem_test, create_open_compare) {
 TEST(shared_mem_test, after_destory) {
   ext::shared_mem_base mem("memory_struct0");
   EXPECT_FALSE(mem.exists());
-}
\ No newline at end of file
+}
+#if !defined(_WIN32)
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+struct memory_struct1 {
+  memory_struct1() : value(7) {}
+  int value;
+  char payload[64 * 1024];
+};
+
+TEST(shared_mem_test, map_options) {
+  std::string name = "memory_struct1_" + std::to_string(getpid());
+  ext::shared_mem<memory_struct1> st_mem(
+      name.c_str(), shared_mem_all_access, perm_unspecified, 0,
+      shared_mem_map_populate | shared_mem_map_huge_pages |
+          shared_mem_map_random);
+  EXPECT_TRUE(st_mem.created());
+  EXPECT_EQ(st_mem.map_options(),
+            shared_mem_map_populate | shared_mem_map_huge_pages |
+                shared_mem_map_random);
+  ASSERT_NE(st_mem(), (memory_struct1 *)nullptr);
+  EXPECT_EQ(st_mem->value, 7);
+  st_mem->payload[sizeof(st_mem->payload) - 1] = 'x';
+
+  ext::shared_mem_base mem(name.c_str());
+  EXPECT_TRUE(mem.open(shared_mem_read_write_access));
+  const size_t page_size = get_page_size();
+  void *locked = mem.map(0, page_size, shared_mem_read_access, nullptr,
+                         shared_mem_map_lock | shared_mem_map_will_need);
+  ASSERT_NE(locked, (void *)nullptr);
+  EXPECT_EQ(static_cast<memory_struct1 *>(locked)->value, 7);
+  EXPECT_TRUE(mem.unmap(locked, page_size));
+
+  memory_struct1 *sequential = static_cast<memory_struct1 *>(
+      mem.map(0, sizeof(memory_struct1), shared_mem_read_access, nullptr,
+              shared_mem_map_sequential | shared_mem_map_populate));
+  ASSERT_NE(sequential, (memory_struct1 *)nullptr);
+  EXPECT_EQ(sequential->payload[sizeof(sequential->payload) - 1], 'x');
+  EXPECT_TRUE(mem.unmap(sequential, sizeof(memory_struct1)));
+
+  st_mem.destroy();
+}
+
+namespace {
+std::atomic<int> failing_object_count(0);
+std::atomic<bool> failing_object_release(false);
+
+// The first object waits until it is released and then throws.
+struct failing_object {
+  failing_object() : value(1) {
+    if (failing_object_count++ != 0)
+      return;
+    while (!failing_object_release)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    throw std::runtime_error("failing_object");
+  }
+  int value;
+};
+} // namespace
+
+TEST(shared_mem_test, object_creation_failure) {
+  std::string name = "shared_mem_object_" + std::to_string(getpid());
+  bool creator_failed = false;
+  bool opener_failed = false;
+  std::thread creator([&name, &creator_failed]() {
+    try {
+      ext::details::shared_mem_object<failing_object> object(name.c_str());
+    } catch (const std::runtime_error &) {
+      creator_failed = true;
+    }
+  });
+  while (failing_object_count == 0)
+    std::this_thread::yield();
+
+  // The opener waits for the creator, and fails as soon as the constructor of
+  // T throws instead of waiting forever.
+  std::thread opener([&name, &opener_failed]() {
+    try {
+      ext::details::shared_mem_object<failing_object> object(name.c_str());
+    } catch (const std::runtime_error &) {
+      opener_failed = true;
+    }
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  failing_object_release = true;
+  creator.join();
+  opener.join();
+  EXPECT_TRUE(creator_failed);
+  EXPECT_TRUE(opener_failed);
+
+  // The failed object was unlinked, so it is created again.
+  ext::details::shared_mem_object<failing_object> object(name.c_str());
+  EXPECT_TRUE(object.created());
+  EXPECT_EQ(object.get().value, 1);
+  EXPECT_TRUE(object.unlink());
+}
+
+namespace {
+void benchmark_mapping(const char *label, shared_mem_map_option options) {
+  const size_t size = 64 * 1024 * 1024;
+  const size_t page_size = get_page_size();
+  std::string name = "shared_mem_bench_" + std::to_string(getpid());
+  ext::shared_mem_base mem(name.c_str());
+  ASSERT_TRUE(mem.create(size, shared_mem_read_write_access));
+
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  char *data = static_cast<char *>(
+      mem.map(0, size, shared_mem_read_write_access, nullptr, options));
+  ASSERT_NE(data, (char *)nullptr);
+  std::chrono::steady_clock::time_point mapped =
+      std::chrono::steady_clock::now();
+  for (size_t offset = 0; offset < size; offset += page_size)
+    data[offset] = 1;
+  std::chrono::steady_clock::time_point touched =
+      std::chrono::steady_clock::now();
+  std::chrono::steady_clock::duration first_touch = touched - mapped;
+
+  std::mt19937_64 random(42);
+  std::vector<size_t> offsets(4000000);
+  for (size_t i = 0; i < offsets.size(); ++i)
+    offsets[i] = static_cast<size_t>(random() % size);
+  touched = std::chrono::steady_clock::now();
+  unsigned long long sum = 0;
+  for (size_t i = 0; i < offsets.size(); ++i)
+    sum += static_cast<unsigned char>(data[offsets[i]]);
+  std::chrono::steady_clock::time_point accessed =
+      std::chrono::steady_clock::now();
+
+  std::cout << label << ": map "
+            << std::chrono::duration_cast<std::chrono::microseconds>(mapped -
+                                                                     start)
+                   .count()
+            << " us, first touch "
+            << std::chrono::duration_cast<std::chrono::microseconds>(
+                   first_touch)
+                   .count()
+            << " us, 4M random reads "
+            << std::chrono::duration_cast<std::chrono::microseconds>(accessed -
+                                                                     touched)
+                   .count()
+            << " us (" << sum << ")\n";
+
+  EXPECT_TRUE(mem.unmap(data, size));
+  EXPECT_TRUE(mem.destroy());
+}
+} // namespace
+
+// Prints timings only; run it with --gtest_also_run_disabled_tests.
+TEST(shared_mem_test, DISABLED_map_options_benchmark) {
+  benchmark_mapping("default", shared_mem_map_default);
+  benchmark_mapping("populate", shared_mem_map_populate);
+  benchmark_mapping("huge_pages", shared_mem_map_huge_pages);
+  benchmark_mapping("huge_pages|populate",
+                    shared_mem_map_huge_pages | shared_mem_map_populate);
+  benchmark_mapping("random", shared_mem_map_random);
+}
+#endif
@@ -0,0 +1,146 @@
+#include <ext/shared_mem_arena>
+#include <gtest/gtest.h>
+
+#ifdef _EXT_SHARED_MEM_ARENA_
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "ipc_test_utils.h"
+
+namespace {
+typedef std::vector<int, ext::shared_mem_allocator<int>> shared_int_vector;
+typedef std::basic_string<char, std::char_traits<char>,
+                          ext::shared_mem_allocator<char>>
+    shared_string;
+typedef std::vector<shared_string, ext::shared_mem_allocator<shared_string>>
+    shared_string_vector;
+} // namespace
+
+TEST(shared_mem_arena_test, offset_ptr) {
+  int values[4] = {1, 2, 3, 4};
+  ext::offset_ptr<int> p(values);
+  ext::offset_ptr<int> copy(p);
+  EXPECT_EQ(copy.get(), values);
+  EXPECT_EQ(*(p + 2), 3);
+  EXPECT_EQ(p[3], 4);
+  ++p;
+  EXPECT_EQ(*p, 2);
+  EXPECT_EQ(p - copy, 1);
+  EXPECT_TRUE(copy < p);
+
+  ext::offset_ptr<int> null;
+  EXPECT_FALSE(null);
+  EXPECT_EQ(null.get(), (int *)nullptr);
+  EXPECT_TRUE(null == nullptr);
+
+  ext::offset_ptr<const void> erased(copy);
+  EXPECT_EQ(static_cast<const int *>(erased.get()), values);
+  ext::offset_ptr<const int> restored(erased);
+  EXPECT_EQ(restored.get(), values);
+}
+
+TEST(shared_mem_arena_test, allocate_and_reuse) {
+  std::string name = unique_name("shared_mem_arena_alloc");
+  ext::shared_mem_arena arena(name.c_str(), 64 * 1024);
+  EXPECT_TRUE(arena.created());
+
+  void *p = arena.allocate(100);
+  ASSERT_NE(p, (void *)nullptr);
+  EXPECT_EQ(reinterpret_cast<size_t>(p) % 16, 0u);
+  EXPECT_TRUE(arena.heap().contains(p));
+  size_t unused = arena.heap().unused();
+
+  // A freed block is reused by the next allocation of the same size class.
+  arena.deallocate(p);
+  EXPECT_EQ(arena.allocate(90), p);
+  EXPECT_EQ(arena.heap().unused(), unused);
+
+  EXPECT_THROW(arena.allocate(1024 * 1024), std::bad_alloc);
+  EXPECT_TRUE(arena.unlink());
+}
+
+TEST(shared_mem_arena_test, concurrent_allocate) {
+  std::string name = unique_name("shared_mem_arena_threads");
+  ext::shared_mem_arena arena(name.c_str(), 4 * 1024 * 1024);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.push_back(std::thread([&arena, t]() {
+      std::vector<int *> blocks;
+      for (int round = 0; round < 200; ++round) {
+        for (int i = 0; i < 50; ++i) {
+          int *p = static_cast<int *>(arena.allocate(sizeof(int) * (i + 1)));
+          *p = t * 100000 + round * 100 + i;
+          blocks.push_back(p);
+        }
+        for (size_t i = 0; i < blocks.size(); ++i)
+          EXPECT_EQ(*blocks[i], t * 100000 + round * 100 + static_cast<int>(i));
+        for (size_t i = 0; i < blocks.size(); ++i)
+          arena.deallocate(blocks[i]);
+        blocks.clear();
+      }
+    }));
+  }
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i].join();
+  EXPECT_TRUE(arena.unlink());
+}
+
+TEST(shared_mem_arena_test, containers_across_processes) {
+  std::string name = unique_name("shared_mem_arena_containers");
+  {
+    ext::shared_mem_arena arena(name.c_str(), 1024 * 1024);
+    shared_string_vector *strings = arena.construct<shared_string_vector>(
+        arena.get_allocator<shared_string>());
+    for (int i = 0; i < 100; ++i)
+      strings->push_back(shared_string(
+          ("a fairly long string that does not fit inline #" +
+           std::to_string(i))
+              .c_str(),
+          arena.get_allocator<char>()));
+    arena.set_root(strings);
+
+    pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0) {
+      // Map the segment again, at a different address.
+      ext::shared_mem_arena child(name.c_str(), 1024 * 1024);
+      shared_string_vector *shared = child.root<shared_string_vector>();
+      if (shared == nullptr || (void *)shared == (void *)strings)
+        _exit(1);
+      if (shared->size() != 100 ||
+          (*shared)[42] != "a fairly long string that does not fit inline #42")
+        _exit(2);
+      // Containers grow with memory from the shared heap.
+      shared->push_back(shared_string("from child", child.get_allocator<char>()));
+      _exit(0);
+    }
+    EXPECT_EQ(wait_child(pid), 0);
+    ASSERT_EQ(strings->size(), 101u);
+    EXPECT_EQ(strings->back(), "from child");
+
+    arena.destroy(strings);
+  }
+  ext::shared_mem_arena arena(name.c_str(), 0);
+  EXPECT_FALSE(arena.created());
+  EXPECT_TRUE(arena.unlink());
+}
+
+TEST(shared_mem_arena_test, vector_of_int) {
+  std::string name = unique_name("shared_mem_arena_vector");
+  ext::shared_mem_arena arena(name.c_str(), 1024 * 1024);
+  shared_int_vector *v =
+      arena.construct<shared_int_vector>(arena.get_allocator<int>());
+  for (int i = 0; i < 10000; ++i)
+    v->push_back(i);
+  long long sum = 0;
+  for (shared_int_vector::iterator it = v->begin(); it != v->end(); ++it)
+    sum += *it;
+  EXPECT_EQ(sum, 10000LL * 9999 / 2);
+  arena.destroy(v);
+  EXPECT_TRUE(arena.unlink());
+}
+#endif // _EXT_SHARED_MEM_ARENA_
@@ -0,0 +1,135 @@
+#include <ext/shared_mem_snapshot>
+#include <gtest/gtest.h>
+
+#ifdef _EXT_SHARED_MEM_SNAPSHOT_
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include "ipc_test_utils.h"
+
+namespace {
+struct quote {
+  long long sequence;
+  long long bid;
+  long long ask;
+  long long check;
+};
+
+quote make_quote(long long i) {
+  quote q = {i, i * 10, i * 10 + 1, -i};
+  return q;
+}
+
+bool is_consistent(const quote &q) {
+  return q.bid == q.sequence * 10 && q.ask == q.bid + 1 &&
+         q.check == -q.sequence;
+}
+} // namespace
+
+TEST(shared_mem_snapshot_test, publish_and_read) {
+  std::string name = unique_name("shared_mem_snapshot_basic");
+  ext::shared_mem_snapshot<quote> snapshot(name.c_str(), make_quote(7));
+  EXPECT_TRUE(snapshot.created());
+  EXPECT_EQ(snapshot.version(), 0u);
+  EXPECT_EQ(snapshot.read().sequence, 7);
+
+  snapshot.publish(make_quote(8));
+  quote q;
+  EXPECT_EQ(snapshot.read(q), 1u);
+  EXPECT_EQ(q.sequence, 8);
+
+  snapshot.update([](quote &value) { value = make_quote(value.sequence + 1); });
+  EXPECT_EQ(snapshot.version(), 2u);
+  EXPECT_EQ(snapshot.read().sequence, 9);
+
+  // The initial value of an existing snapshot is ignored.
+  ext::shared_mem_snapshot<quote> other(name.c_str(), make_quote(100));
+  EXPECT_FALSE(other.created());
+  EXPECT_EQ(other.read().sequence, 9);
+  EXPECT_TRUE(snapshot.unlink());
+}
+
+TEST(shared_mem_snapshot_test, read_if_changed) {
+  std::string name = unique_name("shared_mem_snapshot_changed");
+  ext::shared_mem_snapshot<int> snapshot(name.c_str(), 1);
+  unsigned long long version = snapshot.version();
+  int value = 0;
+  EXPECT_FALSE(snapshot.read_if_changed(value, version));
+  EXPECT_EQ(value, 0);
+
+  snapshot.publish(2);
+  EXPECT_TRUE(snapshot.read_if_changed(value, version));
+  EXPECT_EQ(value, 2);
+  EXPECT_EQ(version, 1u);
+  EXPECT_FALSE(snapshot.read_if_changed(value, version));
+  EXPECT_TRUE(snapshot.unlink());
+}
+
+TEST(shared_mem_snapshot_test, layout_mismatch) {
+  std::string name = unique_name("shared_mem_snapshot_layout");
+  ext::shared_mem_snapshot<int> snapshot(name.c_str());
+  typedef ext::shared_mem_snapshot<quote> other_snapshot;
+  EXPECT_THROW(other_snapshot(name.c_str()), std::runtime_error);
+  EXPECT_TRUE(snapshot.unlink());
+}
+
+TEST(shared_mem_snapshot_test, consistent_reads) {
+  std::string name = unique_name("shared_mem_snapshot_threads");
+  ext::shared_mem_snapshot<quote> snapshot(name.c_str(), make_quote(0));
+  std::atomic<bool> done(false);
+  std::thread writer([&snapshot, &done]() {
+    for (long long i = 1; i <= 200000; ++i)
+      snapshot.publish(make_quote(i));
+    done = true;
+  });
+  // Readers never see a value that is half published, and versions never go
+  // backwards.
+  // The writer is joined before asserting, so that a failure does not leave
+  // it joinable.
+  unsigned long long last = 0;
+  bool consistent = true;
+  bool labelled = true;
+  bool monotonic = true;
+  while (!done && consistent && labelled && monotonic) {
+    quote q;
+    unsigned long long version = snapshot.read(q);
+    consistent = is_consistent(q);
+    labelled = q.sequence == static_cast<long long>(version);
+    monotonic = version >= last;
+    last = version;
+  }
+  writer.join();
+  EXPECT_TRUE(consistent);
+  EXPECT_TRUE(labelled);
+  EXPECT_TRUE(monotonic);
+  EXPECT_EQ(snapshot.read().sequence, 200000);
+  EXPECT_TRUE(snapshot.unlink());
+}
+
+TEST(shared_mem_snapshot_test, across_processes) {
+  std::string name = unique_name("shared_mem_snapshot_fork");
+  ext::shared_mem_snapshot<quote> snapshot(name.c_str(), make_quote(0));
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+  if (pid == 0) {
+    ext::shared_mem_snapshot<quote> reader(name.c_str());
+    if (reader.created())
+      _exit(1);
+    quote q;
+    do {
+      reader.read(q);
+      if (!is_consistent(q))
+        _exit(2);
+    } while (q.sequence < 100000);
+    _exit(0);
+  }
+  for (long long i = 1; i <= 100000; ++i)
+    snapshot.publish(make_quote(i));
+  EXPECT_EQ(wait_child(pid), 0);
+  EXPECT_TRUE(snapshot.unlink());
+}
+#endif // _EXT_SHARED_MEM_SNAPSHOT_
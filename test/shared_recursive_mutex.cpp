@@ -1,6 +1,12 @@
 #include <ext/shared_recursive_mutex>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
 #if defined(_EXT_SHARED_RECURSIVE_MUTEX_)
 TEST(shared_recursive_mutex, lock_test) {
   ext::shared_recursive_mutex mtx;
@@ -13,6 +19,21 @@ TEST(shared_recursive_mutex, lock_test) {
   mtx.unlock();
 }
 
+TEST(shared_recursive_mutex, try_lock_test) {
+  ext::shared_recursive_mutex mtx;
+  EXPECT_TRUE(mtx.try_lock());
+  EXPECT_TRUE(mtx.try_lock());
+  mtx.unlock();
+  mtx.unlock();
+  EXPECT_FALSE(mtx.locked());
+
+  mtx.lock_shared();
+  EXPECT_FALSE(mtx.try_lock());
+  EXPECT_TRUE(mtx.locked());
+  mtx.unlock_shared();
+  EXPECT_FALSE(mtx.locked());
+}
+
 TEST(shared_recursive_mutex, lock_shared_test) {
   ext::shared_recursive_mutex mtx;
   EXPECT_FALSE(mtx.locked());
@@ -24,6 +45,112 @@ TEST(shared_recursive_mutex, lock_shared_test) {
   mtx.unlock_shared();
 }
 
+TEST(shared_recursive_mutex, lock_shared_per_instance_test) {
+  ext::shared_recursive_mutex mtx1;
+  ext::shared_recursive_mutex mtx2;
+  mtx1.lock_shared();
+  mtx1.lock_shared();
+  EXPECT_TRUE(mtx1.locked());
+  EXPECT_FALSE(mtx2.locked());
+  mtx2.lock_shared();
+  mtx1.unlock_shared();
+  mtx1.unlock_shared();
+  EXPECT_FALSE(mtx1.locked());
+  EXPECT_TRUE(mtx2.locked());
+
+  // Another thread can lock exclusively once this thread released mtx1.
+  std::thread writer([&mtx1, &mtx2]() {
+    mtx1.lock();
+    EXPECT_FALSE(mtx2.locked());
+    mtx1.unlock();
+  });
+  writer.join();
+  mtx2.unlock_shared();
+  EXPECT_FALSE(mtx2.locked());
+}
+
+TEST(shared_recursive_mutex, concurrent_test) {
+  ext::shared_recursive_mutex mtx;
+  long long value = 0;
+  std::atomic<bool> stop(false);
+  std::atomic<int> errors(0);
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.push_back(std::thread([&]() {
+      while (!stop) {
+        mtx.lock_shared();
+        long long first = value;
+        mtx.lock_shared();
+        if (value != first)
+          ++errors;
+        mtx.unlock_shared();
+        mtx.unlock_shared();
+      }
+    }));
+  }
+  for (int i = 0; i < 10000; ++i) {
+    mtx.lock();
+    mtx.lock();
+    ++value;
+    mtx.unlock();
+    mtx.unlock();
+  }
+  stop = true;
+  for (size_t i = 0; i < readers.size(); ++i)
+    readers[i].join();
+  EXPECT_EQ(errors.load(), 0);
+  EXPECT_EQ(value, 10000);
+}
+
+template <class Mutex>
+static double shared_lock_benchmark(Mutex &mtx, unsigned int thread_count,
+                                    int iterations) {
+  std::vector<std::thread> threads;
+  std::atomic<unsigned int> ready(0);
+  std::atomic<bool> go(false);
+  for (unsigned int i = 0; i < thread_count; ++i) {
+    threads.push_back(std::thread([&]() {
+      ++ready;
+      while (!go)
+        std::this_thread::yield();
+      for (int n = 0; n < iterations; ++n) {
+        mtx.lock_shared();
+        mtx.unlock_shared();
+      }
+    }));
+  }
+  while (ready != thread_count)
+    std::this_thread::yield();
+  auto start = std::chrono::steady_clock::now();
+  go = true;
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i].join();
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+// Prints timings only; run it with --gtest_also_run_disabled_tests.
+TEST(shared_recursive_mutex, DISABLED_shared_lock_benchmark) {
+  const int iterations = 100000;
+  unsigned int max_threads = std::thread::hardware_concurrency();
+  if (max_threads == 0)
+    max_threads = 2;
+  if (max_threads > 8)
+    max_threads = 8;
+  for (unsigned int threads = 1; threads <= max_threads; threads *= 2) {
+    ext::shared_recursive_mutex recursive_mtx;
+    CXX_SHARED_MUTEX shared_mtx;
+    double recursive_ms =
+        shared_lock_benchmark(recursive_mtx, threads, iterations);
+    double shared_ms = shared_lock_benchmark(shared_mtx, threads, iterations);
+    std::cout << "threads : " << threads
+              << "\text::shared_recursive_mutex : " << recursive_ms << " ms"
+              << "\tshared_mutex : " << shared_ms << " ms" << std::endl;
+    EXPECT_FALSE(recursive_mtx.locked());
+  }
+}
+
 // TEST(shared_recursive_mutex, complex_test) {
 //   ext::shared_recursive_mutex mtx;
 //   mtx.lock_shared();
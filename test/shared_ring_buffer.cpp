@@ -0,0 +1,100 @@
+#include <ext/shared_ring_buffer>
+#include <gtest/gtest.h>
+
+#ifdef _EXT_SHARED_RING_BUFFER_
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "ipc_test_utils.h"
+
+namespace {
+std::string make_message(unsigned int producer, unsigned int index) {
+  // Variable lengths make records wrap at different offsets.
+  return std::to_string(producer) + ":" + std::to_string(index) + ":" +
+         std::string(index % 61, static_cast<char>('a' + index % 26));
+}
+} // namespace
+
+TEST(shared_ring_buffer_test, write_and_read) {
+  std::string name = unique_name("shared_ring_buffer_basic");
+  ext::shared_ring_buffer ring(name.c_str(), 100);
+  EXPECT_EQ(ring.capacity(), 128u);
+  EXPECT_EQ(ring.max_message_size(), 56u);
+  EXPECT_TRUE(ring.empty());
+
+  std::string message;
+  EXPECT_FALSE(ring.try_read(message));
+  EXPECT_FALSE(ring.consume_for([](const void *, size_t) {},
+                                std::chrono::milliseconds(10)));
+
+  // Fill the ring, then drain it; repeat so that records wrap around.
+  for (int round = 0; round < 10; ++round) {
+    int written = 0;
+    while (ring.try_write("0123456789abcdefghij", 20))
+      ++written;
+    EXPECT_GT(written, 0);
+    for (int i = 0; i < written; ++i) {
+      ASSERT_TRUE(ring.try_read(message));
+      EXPECT_EQ(message, "0123456789abcdefghij");
+    }
+    EXPECT_TRUE(ring.empty());
+  }
+
+  // A second instance opens the same ring.
+  ext::shared_ring_buffer other(name.c_str(), 4096);
+  EXPECT_EQ(other.capacity(), 128u);
+  EXPECT_TRUE(other.try_write("hello", 5));
+  size_t size = 0;
+  EXPECT_TRUE(ring.try_consume([&size](const void *data, size_t length) {
+    size = length;
+    EXPECT_EQ(std::string(static_cast<const char *>(data), length), "hello");
+  }));
+  EXPECT_EQ(size, 5u);
+
+  EXPECT_THROW(ring.try_write(std::string(57, 'x').data(), 57),
+               std::length_error);
+  EXPECT_TRUE(ring.unlink());
+}
+
+TEST(shared_ring_buffer_test, multiple_producer_processes) {
+  std::string name = unique_name("shared_ring_buffer_mpsc");
+  ext::shared_ring_buffer ring(name.c_str(), 4096);
+
+  const unsigned int producers = 3;
+  const unsigned int messages = 20000;
+  std::vector<pid_t> pids;
+  for (unsigned int p = 0; p < producers; ++p) {
+    pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0) {
+      ext::shared_ring_buffer child(name.c_str(), 4096);
+      for (unsigned int i = 0; i < messages; ++i) {
+        std::string message = make_message(p, i);
+        child.write(message.data(), message.size());
+      }
+      _exit(0);
+    }
+    pids.push_back(pid);
+  }
+
+  // Messages of each producer arrive in order.
+  std::vector<unsigned int> next(producers, 0);
+  std::string message;
+  for (unsigned int i = 0; i < producers * messages; ++i) {
+    ring.read(message);
+    unsigned int producer =
+        static_cast<unsigned int>(std::stoul(message.substr(0, 1)));
+    ASSERT_LT(producer, producers);
+    ASSERT_EQ(message, make_message(producer, next[producer]));
+    ++next[producer];
+  }
+  EXPECT_TRUE(ring.empty());
+
+  for (size_t i = 0; i < pids.size(); ++i)
+    EXPECT_EQ(wait_child(pids[i]), 0);
+  EXPECT_TRUE(ring.unlink());
+}
+#endif // _EXT_SHARED_RING_BUFFER_